@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+    AdaptiveQuality.h
+    Trades accuracy for speed while blocks take more than their share of the deadline.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Each block's processing time is measured against how long the block lasts,
+    and smoothed with an exponential moving average, so one slow block, e.g. a
+    page fault, doesn't change anything on its own.
+    
+    The budget is this instance's share of the block, not the whole of it: a
+    busy session runs dozens of plugins on each core, so by the time one
+    instance alone takes most of the deadline the host has long been dropping
+    out. It is given per channel, as the carrier multiply and the oversampling
+    filters all cost in proportion to the channel count, so an immersive stem
+    gets as much room per channel as a stereo track rather than losing its
+    oversampling on an idle machine. The default has to sit above what the
+    user's settings cost on an unloaded machine, which RingModulatorBenchmarks
+    in the test project measures, so check it there before relying on it.
+    
+    After every change the level is held while the average settles to the
+    new cost. Levels don't all differ by the same amount, e.g. turning
+    oversampling back on costs far more than halving it, so each step down
+    also records how much more the level above cost than the one it landed
+    on. Quality only comes back once that step up, scaled to the current
+    load, is predicted to stay under stepUpShare of the budget for
+    stepUpSeconds, so a busy session doesn't flap between two levels.
+    
+    Level 0 is the quality the user asked for, and every level above it is
+    cheaper. What each level gives up is the caller's choice.
+    
+    update is called from the audio thread, getLevel and setBudgetPerChannel
+    from any thread.
+*/
+class AdaptiveQuality
+{
+public:
+    static constexpr int maxLevel = 4;
+    //the fraction of each block's duration this instance may take per channel before it steps down, 5% for stereo
+    static constexpr double defaultBudgetPerChannel = 0.025;
+    //quality comes back once the level above is predicted to take under this fraction of the budget. The margin
+    //covers the prediction being off, as the cost of a step is measured under whatever else the machine was doing then
+    static constexpr double stepUpShare = 0.7;
+    //what a step up is assumed to cost before one has been measured, as each oversampling step halves the cost
+    static constexpr double defaultStepUpCost = 2.0;
+    //how quickly the average follows the measured load, and how long a new level is kept before the next change
+    static constexpr double averagingSeconds = 0.1;
+    static constexpr double holdSeconds = 0.5;
+    //how long the level above has to be predicted to fit before quality comes back
+    static constexpr double stepUpSeconds = 2.0;
+    
+    //==============================================================================
+    void reset() noexcept
+    {
+        averageLoad = 0.0;
+        secondsSinceChange = 0.0;
+        secondsWithHeadroom = 0.0;
+        loadBeforeStepDown = 0.0;
+        isMeasuringStepDown = false;
+        std::fill (std::begin (stepUpCosts), std::end (stepUpCosts), 0.0);
+        level.store (0, std::memory_order_relaxed);
+    }
+    
+    //a fraction of each block's duration for every channel processed, from 0.001 up to 1 for all of it
+    void setBudgetPerChannel (double fractionOfDeadline) noexcept
+    {
+        budgetPerChannel.store (juce::jlimit (0.001, 1.0, fractionOfDeadline), std::memory_order_relaxed);
+    }
+    
+    double getBudgetPerChannel() const noexcept     { return budgetPerChannel.load (std::memory_order_relaxed); }
+    
+    //how long a block of numSamples and numChannels took to process. Returns the level to use from the next block on
+    int update (double secondsTaken, int numSamples, int numChannels, double sampleRate) noexcept
+    {
+        auto currentLevel = level.load (std::memory_order_relaxed);
+        auto stepDownLoad = juce::jmin (1.0, getBudgetPerChannel() * juce::jmax (1, numChannels));
+        
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return currentLevel;
+        
+        auto blockSeconds = (double) numSamples / sampleRate;
+        //weighted by the block's duration, so the average takes the same time to respond whatever the block size
+        auto weight = 1.0 - std::exp (-blockSeconds / averagingSeconds);
+        averageLoad += weight * (secondsTaken / blockSeconds - averageLoad);
+        
+        secondsSinceChange += blockSeconds;
+        
+        //once the average has settled after a step down, comparing it with the load before says what stepping back up costs
+        if (isMeasuringStepDown && secondsSinceChange >= holdSeconds)
+        {
+            stepUpCosts[currentLevel] = loadBeforeStepDown / juce::jmax (averageLoad, 1.0e-6);
+            isMeasuringStepDown = false;
+        }
+        
+        //the load the level above would put on the machine as busy as it is now
+        auto stepUpCost = stepUpCosts[currentLevel] > 0.0 ? stepUpCosts[currentLevel] : defaultStepUpCost;
+        auto hasHeadroom = currentLevel > 0 && ! isMeasuringStepDown && averageLoad * stepUpCost < stepDownLoad * stepUpShare;
+        secondsWithHeadroom = hasHeadroom ? secondsWithHeadroom + blockSeconds : 0.0;
+        
+        if (secondsSinceChange >= holdSeconds)
+        {
+            if (averageLoad > stepDownLoad && currentLevel < maxLevel)
+                changeLevel (currentLevel + 1);
+            else if (secondsWithHeadroom >= stepUpSeconds && currentLevel > 0)
+                changeLevel (currentLevel - 1);
+        }
+        
+        return level.load (std::memory_order_relaxed);
+    }
+    
+    //0 for full quality, up to maxLevel
+    int getLevel() const noexcept                   { return level.load (std::memory_order_relaxed); }
+
+private:
+    void changeLevel (int newLevel) noexcept
+    {
+        isMeasuringStepDown = newLevel > level.load (std::memory_order_relaxed);
+        loadBeforeStepDown = averageLoad;
+        level.store (newLevel, std::memory_order_relaxed);
+        secondsSinceChange = 0.0;
+        secondsWithHeadroom = 0.0;
+    }
+    
+    double averageLoad { 0 };
+    double secondsSinceChange { 0 };
+    double secondsWithHeadroom { 0 };
+    //how many times more the level above each one cost, measured on the last step down into it, or 0 before that
+    double stepUpCosts[maxLevel + 1] {};
+    double loadBeforeStepDown { 0 };
+    bool isMeasuringStepDown { false };
+    std::atomic <int> level { 0 };
+    std::atomic <double> budgetPerChannel { defaultBudgetPerChannel };
+};
@@ -0,0 +1,750 @@
+/*
+  ==============================================================================
+
+    CarrierKernels.h
+    Hand vectorised versions of the carrier render, the ring-mod multiply and
+    the glide's increment ramp, picked once at prepareToPlay time from what
+    the CPU supports.
+    
+    Each kernel is compiled for its own instruction set using per-function
+    target attributes, so the rest of the plugin keeps the baseline flags.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SineTable.h"
+#include "FixedPointSine.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ 
+ #if JUCE_MSVC
+  #define RINGMOD_TARGET(isa)
+ #else
+  #define RINGMOD_TARGET(isa) __attribute__ ((target (isa)))
+ #endif
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+namespace CarrierKernels
+{
+    enum class InstructionSet
+    {
+        scalar,
+        sse2,
+        sse41,
+        avx2,
+        avx512,
+        neon
+    };
+    
+    //the contract every float carrier render follows, whichever engine or instruction set: fills dest with gain * sin (phase),
+    //stepping the phase by a constant increment, and returns the phase after the last sample for the next call to carry on from
+    using RenderFunction = juce::uint32 (*) (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table);
+    //dest[i] *= carrier[i]
+    using MultiplyFunction = void (*) (float* dest, const float* carrier, int numSamples);
+    //left[i] *= carrier[i], right[i] *= carrier[i], loading each carrier vector once for both channels
+    using MultiplyStereoFunction = void (*) (float* left, float* right, const float* carrier, int numSamples);
+    //the fixed point engine's versions of render and multiply, exactly matching FixedPointSine's scalar reference
+    using FixedPointRenderFunction = juce::uint32 (*) (juce::int16* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, const FixedPointSine& table);
+    using FixedPointMultiplyFunction = void (*) (float* audio, const juce::int16* carrier, int numSamples);
+    //increments[i] is the phase increment for glideValues[i], a frequency in Hz, or its log2 for a logarithmic glide
+    using GlideIncrementFunction = void (*) (juce::uint32* increments, const float* glideValues, int numSamples, bool isLogarithmic, float incrementsPerHz);
+    
+    struct Kernels
+    {
+        RenderFunction getRenderFunction (SineTable::Interpolation interpolation) const noexcept
+        {
+            switch (interpolation)
+            {
+                case SineTable::Interpolation::linear:  return renderLinear;
+                case SineTable::Interpolation::hermite: return renderHermite;
+                case SineTable::Interpolation::none:    break;
+            }
+            
+            return render;
+        }
+        
+        InstructionSet instructionSet;
+        RenderFunction render;
+        RenderFunction renderLinear;
+        //scalar on every instruction set, the four point gathers cost more than they save
+        RenderFunction renderHermite;
+        MultiplyFunction multiply;
+        MultiplyStereoFunction multiplyStereo;
+        //scalar below SSE4.1, which is the first x86 instruction set with 32 x 32 -> 64 bit signed multiplies
+        FixedPointRenderFunction renderFixedPoint;
+        FixedPointMultiplyFunction multiplyFixedPoint;
+        //AVX-512 uses the AVX2 version, a glide is too short for the wider vectors to pay off
+        GlideIncrementFunction glideIncrements;
+    };
+    
+    //largest difference allowed between a vectorised kernel and the scalar reference, checked by CarrierKernelsTests
+    constexpr float tolerance = 1.0e-6f;
+    //largest error allowed in a glide increment, relative to the exact one, checked by CarrierKernelsTests
+    constexpr double glideTolerance = 1.0e-6;
+    
+    //2^f for |f| <= 0.5 from its Taylor series, which is within float rounding of the exact value over that range
+    constexpr float exp2Coefficients[] = { 1.0f, 0.693147181f, 0.240226507f, 0.0555041087f, 0.00961812911f, 0.00133335581f, 0.000154035304f };
+    //the largest increment, half a cycle per sample. The vector conversions turn it into 0x80000000, which is 2^31 unsigned
+    constexpr float largestIncrement = 2147483648.0f;
+    
+    //==============================================================================
+    inline juce::uint32 renderScalar (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = table[phase] * gain;
+            phase += increment;
+        }
+        
+        return phase;
+    }
+    
+    inline juce::uint32 renderLinearScalar (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = table.lookupLinear (phase) * gain;
+            phase += increment;
+        }
+        
+        return phase;
+    }
+    
+    inline juce::uint32 renderHermiteScalar (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = table.lookupHermite (phase) * gain;
+            phase += increment;
+        }
+        
+        return phase;
+    }
+    
+    inline void multiplyScalar (float* dest, const float* carrier, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] *= carrier[i];
+    }
+    
+    inline void multiplyStereoScalar (float* left, float* right, const float* carrier, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            left[i] *= carrier[i];
+            right[i] *= carrier[i];
+        }
+    }
+    
+    inline juce::uint32 renderFixedPointScalar (juce::int16* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, const FixedPointSine& table)
+    {
+        return table.render (dest, numSamples, phase, increment);
+    }
+    
+    inline void multiplyFixedPointScalar (float* audio, const juce::int16* carrier, int numSamples)
+    {
+        FixedPointSine::multiply (audio, carrier, numSamples);
+    }
+    
+    //2^x as 2^n * 2^f with n the nearest integer, so the series only has to cover |f| <= 0.5
+    inline float exp2Scalar (float x) noexcept
+    {
+        x = juce::jlimit (-126.0f, 126.0f, x);
+        auto n = juce::roundToInt (x);
+        auto f = x - (float) n;
+        auto power = exp2Coefficients[6];
+        
+        for (int i = 5; i >= 0; --i)
+            power = power * f + exp2Coefficients[i];
+        
+        auto bits = (juce::uint32) (n + 127) << 23;
+        float scale;
+        std::memcpy (&scale, &bits, sizeof (scale));
+        return power * scale;
+    }
+    
+    inline void glideIncrementsScalar (juce::uint32* increments, const float* glideValues, int numSamples, bool isLogarithmic, float incrementsPerHz)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto frequency = isLogarithmic ? exp2Scalar (glideValues[i]) : glideValues[i];
+            increments[i] = (juce::uint32) (juce::int64) (juce::jlimit (0.0f, largestIncrement, frequency * incrementsPerHz) + 0.5f);
+        }
+    }
+   
+   #if JUCE_INTEL
+    //==============================================================================
+    //SSE2 has no gather, so the phases are stepped four at a time and the table reads stay scalar
+    RINGMOD_TARGET ("sse2")
+    inline juce::uint32 renderSSE2 (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        alignas (16) juce::uint32 indices[4];
+        auto phases = _mm_setr_epi32 ((int) phase, (int) (phase + increment), (int) (phase + 2 * increment), (int) (phase + 3 * increment));
+        auto step = _mm_set1_epi32 ((int) (4 * increment));
+        auto gains = _mm_set1_ps (gain);
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            _mm_store_si128 ((__m128i*) indices, _mm_srli_epi32 (phases, SineTable::phaseToIndexShift));
+            auto values = _mm_setr_ps (table.values[indices[0]], table.values[indices[1]], table.values[indices[2]], table.values[indices[3]]);
+            _mm_storeu_ps (dest + i, _mm_mul_ps (values, gains));
+            phases = _mm_add_epi32 (phases, step);
+        }
+        
+        return renderScalar (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment, gain, table);
+    }
+    
+    RINGMOD_TARGET ("sse2")
+    inline juce::uint32 renderLinearSSE2 (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        alignas (16) juce::uint32 indices[4];
+        auto phases = _mm_setr_epi32 ((int) phase, (int) (phase + increment), (int) (phase + 2 * increment), (int) (phase + 3 * increment));
+        auto step = _mm_set1_epi32 ((int) (4 * increment));
+        auto fractionMask = _mm_set1_epi32 ((int) SineTable::fractionMask);
+        auto fractionScale = _mm_set1_ps (1.0f / (float) (1u << SineTable::phaseToIndexShift));
+        auto gains = _mm_set1_ps (gain);
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            _mm_store_si128 ((__m128i*) indices, _mm_srli_epi32 (phases, SineTable::phaseToIndexShift));
+            auto values = _mm_setr_ps (table.values[indices[0]], table.values[indices[1]], table.values[indices[2]], table.values[indices[3]]);
+            auto slopes = _mm_setr_ps (table.slopes[indices[0]], table.slopes[indices[1]], table.slopes[indices[2]], table.slopes[indices[3]]);
+            auto fractions = _mm_mul_ps (_mm_cvtepi32_ps (_mm_and_si128 (phases, fractionMask)), fractionScale);
+            _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_add_ps (values, _mm_mul_ps (fractions, slopes)), gains));
+            phases = _mm_add_epi32 (phases, step);
+        }
+        
+        return renderLinearScalar (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment, gain, table);
+    }
+    
+    RINGMOD_TARGET ("sse2")
+    inline void multiplySSE2 (float* dest, const float* carrier, int numSamples)
+    {
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_loadu_ps (dest + i), _mm_loadu_ps (carrier + i)));
+        
+        multiplyScalar (dest + i, carrier + i, numSamples - i);
+    }
+    
+    RINGMOD_TARGET ("sse2")
+    inline void multiplyStereoSSE2 (float* left, float* right, const float* carrier, int numSamples)
+    {
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto carrierVector = _mm_loadu_ps (carrier + i);
+            _mm_storeu_ps (left + i,  _mm_mul_ps (_mm_loadu_ps (left + i),  carrierVector));
+            _mm_storeu_ps (right + i, _mm_mul_ps (_mm_loadu_ps (right + i), carrierVector));
+        }
+        
+        multiplyStereoScalar (left + i, right + i, carrier + i, numSamples - i);
+    }
+    
+    //exp2Scalar and the clamp to an increment, four samples at a time
+    RINGMOD_TARGET ("sse2")
+    inline __m128i glideToIncrementsSSE2 (__m128 glideValues, bool isLogarithmic, __m128 incrementsPerHz)
+    {
+        auto frequencies = glideValues;
+        
+        if (isLogarithmic)
+        {
+            auto x = _mm_min_ps (_mm_max_ps (glideValues, _mm_set1_ps (-126.0f)), _mm_set1_ps (126.0f));
+            auto n = _mm_cvtps_epi32 (x);
+            auto f = _mm_sub_ps (x, _mm_cvtepi32_ps (n));
+            auto power = _mm_set1_ps (exp2Coefficients[6]);
+            
+            for (int i = 5; i >= 0; --i)
+                power = _mm_add_ps (_mm_mul_ps (power, f), _mm_set1_ps (exp2Coefficients[i]));
+            
+            frequencies = _mm_mul_ps (power, _mm_castsi128_ps (_mm_slli_epi32 (_mm_add_epi32 (n, _mm_set1_epi32 (127)), 23)));
+        }
+        
+        auto increments = _mm_min_ps (_mm_max_ps (_mm_mul_ps (frequencies, incrementsPerHz), _mm_setzero_ps()), _mm_set1_ps (largestIncrement));
+        return _mm_cvtps_epi32 (increments);
+    }
+    
+    RINGMOD_TARGET ("sse2")
+    inline void glideIncrementsSSE2 (juce::uint32* increments, const float* glideValues, int numSamples, bool isLogarithmic, float incrementsPerHz)
+    {
+        auto scale = _mm_set1_ps (incrementsPerHz);
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_si128 ((__m128i*) (increments + i), glideToIncrementsSSE2 (_mm_loadu_ps (glideValues + i), isLogarithmic, scale));
+        
+        //the tail goes through the same vector code, so a sample's increment doesn't depend on where a tile splits the glide
+        if (i < numSamples)
+        {
+            alignas (16) float tailValues[4] = {};
+            alignas (16) juce::uint32 tailIncrements[4];
+            std::copy (glideValues + i, glideValues + numSamples, tailValues);
+            _mm_store_si128 ((__m128i*) tailIncrements, glideToIncrementsSSE2 (_mm_load_ps (tailValues), isLogarithmic, scale));
+            std::copy (tailIncrements, tailIncrements + (numSamples - i), increments + i);
+        }
+    }
+    
+    //==============================================================================
+    //the fixed point engine's kernels for x86 without AVX2. There is no gather, so the table reads stay scalar
+    //and everything after them is vectorised, as in the AVX2 versions
+    RINGMOD_TARGET ("sse4.1")
+    inline juce::uint32 renderFixedPointSSE41 (juce::int16* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, const FixedPointSine& table)
+    {
+        alignas (16) juce::uint32 phases[8];
+        alignas (16) juce::int16 values[8], nextValues[8];
+        auto lanes = _mm_setr_epi32 (0, 1, 2, 3);
+        auto lowPhases = _mm_add_epi32 (_mm_set1_epi32 ((int) phase), _mm_mullo_epi32 (lanes, _mm_set1_epi32 ((int) increment)));
+        auto halfStep = _mm_set1_epi32 ((int) (4 * increment));
+        auto step = _mm_set1_epi32 ((int) (8 * increment));
+        auto fractionMask = _mm_set1_epi32 (0x7fff);
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            auto highPhases = _mm_add_epi32 (lowPhases, halfStep);
+            _mm_store_si128 ((__m128i*) phases, lowPhases);
+            _mm_store_si128 ((__m128i*) (phases + 4), highPhases);
+            
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                auto index = phases[lane] >> FixedPointSine::phaseToIndexShift;
+                values[lane] = table.values[index];
+                nextValues[lane] = table.values[index + 1];
+            }
+            
+            auto valueVector = _mm_load_si128 ((const __m128i*) values);
+            auto differences = _mm_sub_epi16 (_mm_load_si128 ((const __m128i*) nextValues), valueVector);
+            auto fractions = _mm_packs_epi32 (_mm_and_si128 (_mm_srli_epi32 (lowPhases, FixedPointSine::fractionShift), fractionMask),
+                                              _mm_and_si128 (_mm_srli_epi32 (highPhases, FixedPointSine::fractionShift), fractionMask));
+            
+            //pmulhrsw is (a * b + 2^14) >> 15, the same rounding as FixedPointSine::lookup
+            _mm_storeu_si128 ((__m128i*) (dest + i), _mm_add_epi16 (valueVector, _mm_mulhrs_epi16 (differences, fractions)));
+            lowPhases = _mm_add_epi32 (lowPhases, step);
+        }
+        
+        return table.render (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment);
+    }
+    
+    RINGMOD_TARGET ("sse4.1")
+    inline void multiplyFixedPointSSE41 (float* audio, const juce::int16* carrier, int numSamples)
+    {
+        auto toQ31 = _mm_set1_ps (2147483648.0f);
+        auto fromQ31 = _mm_set1_ps (1.0f / 2147483648.0f);
+        auto lowest = _mm_set1_ps (-2147483648.0f);
+        auto highest = _mm_set1_ps (2147483520.0f);
+        auto rounding = _mm_set1_epi64x (1 << 14);
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto scaled = _mm_min_ps (_mm_max_ps (_mm_mul_ps (_mm_loadu_ps (audio + i), toQ31), lowest), highest);
+            auto samples = _mm_cvttps_epi32 (scaled);
+            auto gains = _mm_cvtepi16_epi32 (_mm_loadl_epi64 ((const __m128i*) (carrier + i)));
+            
+            //the same even then odd lane products as multiplyFixedPointAVX2
+            auto even = _mm_srli_epi64 (_mm_add_epi64 (_mm_mul_epi32 (samples, gains), rounding), 15);
+            auto odd = _mm_slli_epi64 (_mm_add_epi64 (_mm_mul_epi32 (_mm_srli_epi64 (samples, 32), _mm_srli_epi64 (gains, 32)), rounding), 17);
+            auto products = _mm_blend_epi16 (even, odd, 0xcc);
+            
+            _mm_storeu_ps (audio + i, _mm_mul_ps (_mm_cvtepi32_ps (products), fromQ31));
+        }
+        
+        FixedPointSine::multiply (audio + i, carrier + i, numSamples - i);
+    }
+    
+    //==============================================================================
+    RINGMOD_TARGET ("avx2")
+    inline juce::uint32 renderAVX2 (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        auto lanes = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+        auto phases = _mm256_add_epi32 (_mm256_set1_epi32 ((int) phase), _mm256_mullo_epi32 (lanes, _mm256_set1_epi32 ((int) increment)));
+        auto step = _mm256_set1_epi32 ((int) (8 * increment));
+        auto gains = _mm256_set1_ps (gain);
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            auto indices = _mm256_srli_epi32 (phases, SineTable::phaseToIndexShift);
+            _mm256_storeu_ps (dest + i, _mm256_mul_ps (_mm256_i32gather_ps (table.values, indices, 4), gains));
+            phases = _mm256_add_epi32 (phases, step);
+        }
+        
+        return renderScalar (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment, gain, table);
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline juce::uint32 renderLinearAVX2 (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        auto lanes = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+        auto phases = _mm256_add_epi32 (_mm256_set1_epi32 ((int) phase), _mm256_mullo_epi32 (lanes, _mm256_set1_epi32 ((int) increment)));
+        auto step = _mm256_set1_epi32 ((int) (8 * increment));
+        auto fractionMask = _mm256_set1_epi32 ((int) SineTable::fractionMask);
+        auto fractionScale = _mm256_set1_ps (1.0f / (float) (1u << SineTable::phaseToIndexShift));
+        auto gains = _mm256_set1_ps (gain);
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            auto indices = _mm256_srli_epi32 (phases, SineTable::phaseToIndexShift);
+            auto fractions = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_and_si256 (phases, fractionMask)), fractionScale);
+            //a separate multiply and add rather than fmadd, so the body rounds exactly like lookupLinear in the tail
+            auto values = _mm256_add_ps (_mm256_i32gather_ps (table.values, indices, 4), _mm256_mul_ps (fractions, _mm256_i32gather_ps (table.slopes, indices, 4)));
+            _mm256_storeu_ps (dest + i, _mm256_mul_ps (values, gains));
+            phases = _mm256_add_epi32 (phases, step);
+        }
+        
+        return renderLinearScalar (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment, gain, table);
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline void multiplyAVX2 (float* dest, const float* carrier, int numSamples)
+    {
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+            _mm256_storeu_ps (dest + i, _mm256_mul_ps (_mm256_loadu_ps (dest + i), _mm256_loadu_ps (carrier + i)));
+        
+        multiplyScalar (dest + i, carrier + i, numSamples - i);
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline void multiplyStereoAVX2 (float* left, float* right, const float* carrier, int numSamples)
+    {
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            auto carrierVector = _mm256_loadu_ps (carrier + i);
+            _mm256_storeu_ps (left + i,  _mm256_mul_ps (_mm256_loadu_ps (left + i),  carrierVector));
+            _mm256_storeu_ps (right + i, _mm256_mul_ps (_mm256_loadu_ps (right + i), carrierVector));
+        }
+        
+        multiplyStereoScalar (left + i, right + i, carrier + i, numSamples - i);
+    }
+    
+    //eight Q15 table reads. Each gather fetches a value and its neighbour together as one 32 bit pair,
+    //and the values come back as 32 bit lanes for the caller to pack
+    RINGMOD_TARGET ("avx2")
+    inline void lookupFixedPointAVX2 (__m256i phases, const FixedPointSine& table, __m256i& values, __m256i& nextValues, __m256i& fractions)
+    {
+        auto pairs = _mm256_i32gather_epi32 ((const int*) table.values, _mm256_srli_epi32 (phases, FixedPointSine::phaseToIndexShift), 2);
+        values = _mm256_srai_epi32 (_mm256_slli_epi32 (pairs, 16), 16);
+        nextValues = _mm256_srai_epi32 (pairs, 16);
+        fractions = _mm256_and_si256 (_mm256_srli_epi32 (phases, FixedPointSine::fractionShift), _mm256_set1_epi32 (0x7fff));
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline juce::uint32 renderFixedPointAVX2 (juce::int16* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, const FixedPointSine& table)
+    {
+        auto lanes = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+        auto phases = _mm256_add_epi32 (_mm256_set1_epi32 ((int) phase), _mm256_mullo_epi32 (lanes, _mm256_set1_epi32 ((int) increment)));
+        auto halfStep = _mm256_set1_epi32 ((int) (8 * increment));
+        auto step = _mm256_set1_epi32 ((int) (16 * increment));
+        int i = 0;
+        
+        //sixteen samples at a time, so everything after the gathers works on full vectors of int16
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m256i lowValues, lowNextValues, lowFractions, highValues, highNextValues, highFractions;
+            lookupFixedPointAVX2 (phases, table, lowValues, lowNextValues, lowFractions);
+            lookupFixedPointAVX2 (_mm256_add_epi32 (phases, halfStep), table, highValues, highNextValues, highFractions);
+            
+            //packing interleaves the two halves by 128 bit lane, which the permute at the end undoes
+            auto values = _mm256_packs_epi32 (lowValues, highValues);
+            auto differences = _mm256_sub_epi16 (_mm256_packs_epi32 (lowNextValues, highNextValues), values);
+            auto fractions = _mm256_packs_epi32 (lowFractions, highFractions);
+            
+            //pmulhrsw is (a * b + 2^14) >> 15, the same rounding as FixedPointSine::lookup
+            auto interpolated = _mm256_add_epi16 (values, _mm256_mulhrs_epi16 (differences, fractions));
+            _mm256_storeu_si256 ((__m256i*) (dest + i), _mm256_permute4x64_epi64 (interpolated, 0xd8));
+            phases = _mm256_add_epi32 (phases, step);
+        }
+        
+        return table.render (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment);
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline void multiplyFixedPointAVX2 (float* audio, const juce::int16* carrier, int numSamples)
+    {
+        auto toQ31 = _mm256_set1_ps (2147483648.0f);
+        auto fromQ31 = _mm256_set1_ps (1.0f / 2147483648.0f);
+        auto lowest = _mm256_set1_ps (-2147483648.0f);
+        auto highest = _mm256_set1_ps (2147483520.0f);
+        auto rounding = _mm256_set1_epi64x (1 << 14);
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            //clipped while still float, so the conversion can't overflow
+            auto scaled = _mm256_min_ps (_mm256_max_ps (_mm256_mul_ps (_mm256_loadu_ps (audio + i), toQ31), lowest), highest);
+            auto samples = _mm256_cvttps_epi32 (scaled);
+            auto gains = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i*) (carrier + i)));
+            
+            //64 bit products of the even lanes, then the odd ones. Only the low 32 bits of each product >> 15 are kept,
+            //so logical shifts do, and the odd lanes are shifted straight into the top half for the blend
+            auto even = _mm256_srli_epi64 (_mm256_add_epi64 (_mm256_mul_epi32 (samples, gains), rounding), 15);
+            auto odd = _mm256_slli_epi64 (_mm256_add_epi64 (_mm256_mul_epi32 (_mm256_srli_epi64 (samples, 32), _mm256_srli_epi64 (gains, 32)), rounding), 17);
+            auto products = _mm256_blend_epi32 (even, odd, 0xaa);
+            
+            _mm256_storeu_ps (audio + i, _mm256_mul_ps (_mm256_cvtepi32_ps (products), fromQ31));
+        }
+        
+        FixedPointSine::multiply (audio + i, carrier + i, numSamples - i);
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline __m256i glideToIncrementsAVX2 (__m256 glideValues, bool isLogarithmic, __m256 incrementsPerHz)
+    {
+        auto frequencies = glideValues;
+        
+        if (isLogarithmic)
+        {
+            auto x = _mm256_min_ps (_mm256_max_ps (glideValues, _mm256_set1_ps (-126.0f)), _mm256_set1_ps (126.0f));
+            auto n = _mm256_cvtps_epi32 (x);
+            auto f = _mm256_sub_ps (x, _mm256_cvtepi32_ps (n));
+            auto power = _mm256_set1_ps (exp2Coefficients[6]);
+            
+            for (int i = 5; i >= 0; --i)
+                power = _mm256_add_ps (_mm256_mul_ps (power, f), _mm256_set1_ps (exp2Coefficients[i]));
+            
+            frequencies = _mm256_mul_ps (power, _mm256_castsi256_ps (_mm256_slli_epi32 (_mm256_add_epi32 (n, _mm256_set1_epi32 (127)), 23)));
+        }
+        
+        auto increments = _mm256_min_ps (_mm256_max_ps (_mm256_mul_ps (frequencies, incrementsPerHz), _mm256_setzero_ps()), _mm256_set1_ps (largestIncrement));
+        return _mm256_cvtps_epi32 (increments);
+    }
+    
+    RINGMOD_TARGET ("avx2")
+    inline void glideIncrementsAVX2 (juce::uint32* increments, const float* glideValues, int numSamples, bool isLogarithmic, float incrementsPerHz)
+    {
+        auto scale = _mm256_set1_ps (incrementsPerHz);
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+            _mm256_storeu_si256 ((__m256i*) (increments + i), glideToIncrementsAVX2 (_mm256_loadu_ps (glideValues + i), isLogarithmic, scale));
+        
+        if (i < numSamples)
+        {
+            alignas (32) float tailValues[8] = {};
+            alignas (32) juce::uint32 tailIncrements[8];
+            std::copy (glideValues + i, glideValues + numSamples, tailValues);
+            _mm256_store_si256 ((__m256i*) tailIncrements, glideToIncrementsAVX2 (_mm256_load_ps (tailValues), isLogarithmic, scale));
+            std::copy (tailIncrements, tailIncrements + (numSamples - i), increments + i);
+        }
+    }
+    
+    //==============================================================================
+    RINGMOD_TARGET ("avx512f")
+    inline juce::uint32 renderAVX512 (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        auto lanes = _mm512_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        auto phases = _mm512_add_epi32 (_mm512_set1_epi32 ((int) phase), _mm512_mullo_epi32 (lanes, _mm512_set1_epi32 ((int) increment)));
+        auto step = _mm512_set1_epi32 ((int) (16 * increment));
+        auto gains = _mm512_set1_ps (gain);
+        int i = 0;
+        
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            auto indices = _mm512_srli_epi32 (phases, SineTable::phaseToIndexShift);
+            _mm512_storeu_ps (dest + i, _mm512_mul_ps (_mm512_i32gather_ps (indices, table.values, 4), gains));
+            phases = _mm512_add_epi32 (phases, step);
+        }
+        
+        return renderScalar (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment, gain, table);
+    }
+    
+    RINGMOD_TARGET ("avx512f")
+    inline juce::uint32 renderLinearAVX512 (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain, const SineTable& table)
+    {
+        auto lanes = _mm512_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        auto phases = _mm512_add_epi32 (_mm512_set1_epi32 ((int) phase), _mm512_mullo_epi32 (lanes, _mm512_set1_epi32 ((int) increment)));
+        auto step = _mm512_set1_epi32 ((int) (16 * increment));
+        auto fractionMask = _mm512_set1_epi32 ((int) SineTable::fractionMask);
+        auto fractionScale = _mm512_set1_ps (1.0f / (float) (1u << SineTable::phaseToIndexShift));
+        auto gains = _mm512_set1_ps (gain);
+        int i = 0;
+        
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            auto indices = _mm512_srli_epi32 (phases, SineTable::phaseToIndexShift);
+            auto fractions = _mm512_mul_ps (_mm512_cvtepi32_ps (_mm512_and_si512 (phases, fractionMask)), fractionScale);
+            auto values = _mm512_add_ps (_mm512_i32gather_ps (indices, table.values, 4), _mm512_mul_ps (fractions, _mm512_i32gather_ps (indices, table.slopes, 4)));
+            _mm512_storeu_ps (dest + i, _mm512_mul_ps (values, gains));
+            phases = _mm512_add_epi32 (phases, step);
+        }
+        
+        return renderLinearScalar (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment, gain, table);
+    }
+    
+    RINGMOD_TARGET ("avx512f")
+    inline void multiplyAVX512 (float* dest, const float* carrier, int numSamples)
+    {
+        int i = 0;
+        
+        for (; i + 16 <= numSamples; i += 16)
+            _mm512_storeu_ps (dest + i, _mm512_mul_ps (_mm512_loadu_ps (dest + i), _mm512_loadu_ps (carrier + i)));
+        
+        multiplyScalar (dest + i, carrier + i, numSamples - i);
+    }
+    
+    RINGMOD_TARGET ("avx512f")
+    inline void multiplyStereoAVX512 (float* left, float* right, const float* carrier, int numSamples)
+    {
+        int i = 0;
+        
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            auto carrierVector = _mm512_loadu_ps (carrier + i);
+            _mm512_storeu_ps (left + i,  _mm512_mul_ps (_mm512_loadu_ps (left + i),  carrierVector));
+            _mm512_storeu_ps (right + i, _mm512_mul_ps (_mm512_loadu_ps (right + i), carrierVector));
+        }
+        
+        multiplyStereoScalar (left + i, right + i, carrier + i, numSamples - i);
+    }
+   #endif
+   
+   #if JUCE_USE_ARM_NEON
+    //==============================================================================
+    //the fixed point engine's kernels for ARM, where it has the most to gain. The table reads stay scalar, as there
+    //is no gather, and vqrdmulh takes the place of pmulhrsw
+    inline juce::uint32 renderFixedPointNEON (juce::int16* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, const FixedPointSine& table)
+    {
+        alignas (16) juce::uint32 phases[8];
+        alignas (16) juce::int16 values[8], nextValues[8];
+        const juce::uint32 laneOffsets[] = { 0, increment, 2 * increment, 3 * increment };
+        auto lowPhases = vaddq_u32 (vdupq_n_u32 (phase), vld1q_u32 (laneOffsets));
+        auto halfStep = vdupq_n_u32 (4 * increment);
+        auto step = vdupq_n_u32 (8 * increment);
+        auto fractionMask = vdupq_n_u32 (0x7fff);
+        int i = 0;
+        
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            auto highPhases = vaddq_u32 (lowPhases, halfStep);
+            vst1q_u32 (phases, lowPhases);
+            vst1q_u32 (phases + 4, highPhases);
+            
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                auto index = phases[lane] >> FixedPointSine::phaseToIndexShift;
+                values[lane] = table.values[index];
+                nextValues[lane] = table.values[index + 1];
+            }
+            
+            auto valueVector = vld1q_s16 (values);
+            auto differences = vsubq_s16 (vld1q_s16 (nextValues), valueVector);
+            auto fractions = vcombine_s16 (vmovn_s32 (vreinterpretq_s32_u32 (vandq_u32 (vshrq_n_u32 (lowPhases, FixedPointSine::fractionShift), fractionMask))),
+                                           vmovn_s32 (vreinterpretq_s32_u32 (vandq_u32 (vshrq_n_u32 (highPhases, FixedPointSine::fractionShift), fractionMask))));
+            
+            //vqrdmulh is (2 * a * b + 2^15) >> 16, which is (a * b + 2^14) >> 15. It only saturates for -1 * -1,
+            //and the fractions are never negative
+            vst1q_s16 (dest + i, vaddq_s16 (valueVector, vqrdmulhq_s16 (differences, fractions)));
+            lowPhases = vaddq_u32 (lowPhases, step);
+        }
+        
+        return table.render (dest + i, numSamples - i, phase + (juce::uint32) i * increment, increment);
+    }
+    
+    inline void multiplyFixedPointNEON (float* audio, const juce::int16* carrier, int numSamples)
+    {
+        auto toQ31 = vdupq_n_f32 (2147483648.0f);
+        auto fromQ31 = vdupq_n_f32 (1.0f / 2147483648.0f);
+        auto lowest = vdupq_n_f32 (-2147483648.0f);
+        auto highest = vdupq_n_f32 (2147483520.0f);
+        int i = 0;
+        
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto scaled = vminq_f32 (vmaxq_f32 (vmulq_f32 (vld1q_f32 (audio + i), toQ31), lowest), highest);
+            auto samples = vcvtq_s32_f32 (scaled);
+            auto gains = vmovl_s16 (vld1_s16 (carrier + i));
+            
+            //vrshrn adds 2^14 before the shift, and narrows by keeping the low 32 bits like FixedPointSine::multiply's cast
+            auto low = vrshrn_n_s64 (vmull_s32 (vget_low_s32 (samples), vget_low_s32 (gains)), 15);
+            auto high = vrshrn_n_s64 (vmull_s32 (vget_high_s32 (samples), vget_high_s32 (gains)), 15);
+            
+            vst1q_f32 (audio + i, vmulq_f32 (vcvtq_f32_s32 (vcombine_s32 (low, high)), fromQ31));
+        }
+        
+        FixedPointSine::multiply (audio + i, carrier + i, numSamples - i);
+    }
+   #endif
+   
+    //==============================================================================
+    inline bool isSupported (InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+           #if JUCE_INTEL
+            case InstructionSet::sse2:      return juce::SystemStats::hasSSE2();
+            case InstructionSet::sse41:     return juce::SystemStats::hasSSE41();
+            case InstructionSet::avx2:      return juce::SystemStats::hasAVX2();
+            case InstructionSet::avx512:    return juce::SystemStats::hasAVX512F();
+           #else
+            case InstructionSet::sse2:
+            case InstructionSet::sse41:
+            case InstructionSet::avx2:
+            case InstructionSet::avx512:    return false;
+           #endif
+           #if JUCE_USE_ARM_NEON
+            //NEON is part of the target when it is enabled at compile time
+            case InstructionSet::neon:      return true;
+           #else
+            case InstructionSet::neon:      return false;
+           #endif
+            case InstructionSet::scalar:    return true;
+        }
+        
+        return false;
+    }
+    
+    inline InstructionSet getBestSupportedInstructionSet()
+    {
+        for (auto instructionSet : { InstructionSet::avx512, InstructionSet::avx2, InstructionSet::sse41, InstructionSet::sse2, InstructionSet::neon })
+            if (isSupported (instructionSet))
+                return instructionSet;
+        
+        return InstructionSet::scalar;
+    }
+    
+    //falls back to the scalar kernels if the instruction set isn't available on this machine
+    inline Kernels getKernels (InstructionSet instructionSet)
+    {
+        if (isSupported (instructionSet))
+        {
+            switch (instructionSet)
+            {
+               #if JUCE_INTEL
+                case InstructionSet::sse2:      return { instructionSet, renderSSE2,   renderLinearSSE2,   renderHermiteScalar, multiplySSE2,   multiplyStereoSSE2,
+                                                         renderFixedPointScalar, multiplyFixedPointScalar, glideIncrementsSSE2 };
+                case InstructionSet::sse41:     return { instructionSet, renderSSE2,   renderLinearSSE2,   renderHermiteScalar, multiplySSE2,   multiplyStereoSSE2,
+                                                         renderFixedPointSSE41,  multiplyFixedPointSSE41,  glideIncrementsSSE2 };
+                case InstructionSet::avx2:      return { instructionSet, renderAVX2,   renderLinearAVX2,   renderHermiteScalar, multiplyAVX2,   multiplyStereoAVX2,
+                                                         renderFixedPointAVX2,   multiplyFixedPointAVX2,   glideIncrementsAVX2 };
+                case InstructionSet::avx512:    return { instructionSet, renderAVX512, renderLinearAVX512, renderHermiteScalar, multiplyAVX512, multiplyStereoAVX512,
+                                                         renderFixedPointAVX2,   multiplyFixedPointAVX2,   glideIncrementsAVX2 };
+               #endif
+               #if JUCE_USE_ARM_NEON
+                case InstructionSet::neon:      return { instructionSet, renderScalar, renderLinearScalar, renderHermiteScalar, multiplyScalar, multiplyStereoScalar,
+                                                         renderFixedPointNEON,   multiplyFixedPointNEON,   glideIncrementsScalar };
+               #endif
+                default:                        break;
+            }
+        }
+        
+        return { InstructionSet::scalar, renderScalar, renderLinearScalar, renderHermiteScalar, multiplyScalar, multiplyStereoScalar,
+                 renderFixedPointScalar, multiplyFixedPointScalar, glideIncrementsScalar };
+    }
+}
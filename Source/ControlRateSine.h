@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    ControlRateSine.h
+    A cheap carrier for sub-audio frequencies, evaluated at control rate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SineTable.h"
+
+//==============================================================================
+/**
+    At tremolo rates the carrier barely moves from one sample to the next, so
+    it is only evaluated every interval samples and joined up with straight
+    lines. Joining points d radians apart is out by at most d^2 / 8, so the
+    interval is picked from the frequency to keep that under maxError. Above
+    the frequency where even minInterval would be too coarse, getInterval
+    returns 0 and the audio rate engines take over.
+    
+    Every control point is an exact Hermite table read of the phase
+    accumulator, and nothing is carried over between renders, so moving in
+    and out of control rate never leaves a step in the carrier.
+    
+    The control points sit where the caller's sample position is a multiple
+    of the interval, not where each render starts, so the carrier comes out
+    the same whatever size of blocks it is rendered in.
+*/
+struct ControlRateSine
+{
+    static constexpr int minInterval = 16;
+    static constexpr int maxInterval = 64;
+    //~ -100 dB, well under the interpolated table and the medium polynomial
+    static constexpr double maxError = 1.0e-5;
+    
+    //the longest control interval that stays within maxError at this increment, or 0 if the carrier is too fast for control rate
+    static int getInterval (juce::uint32 increment) noexcept
+    {
+        auto radiansPerSample = juce::MathConstants<double>::twoPi * (double) increment / 4294967296.0;
+        
+        for (int interval = maxInterval; interval >= minInterval; interval /= 2)
+        {
+            auto radiansPerInterval = radiansPerSample * interval;
+            
+            if (radiansPerInterval * radiansPerInterval * 0.125 <= maxError)
+                return interval;
+        }
+        
+        return 0;
+    }
+    
+    //renders to the CarrierKernels::RenderFunction contract.
+    //position is where dest starts in samples since the carrier started, and picks which samples the control points land on
+    static juce::uint32 render (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain,
+                                int interval, juce::int64 position, const SineTable& table) noexcept
+    {
+        jassert (juce::isPowerOfTwo (interval));
+        
+        //the first line starts at the control point before dest, which may be part way through an interval
+        auto offset = (int) (position & (interval - 1));
+        auto controlStep = (juce::uint32) interval * increment;
+        auto controlPhase = phase - (juce::uint32) offset * increment;
+        auto current = table.lookupHermite (controlPhase) * gain;
+        
+        for (int start = -offset; start < numSamples; start += interval)
+        {
+            controlPhase += controlStep;
+            auto next = table.lookupHermite (controlPhase) * gain;
+            auto slope = (next - current) / (float) interval;
+            auto first = juce::jmax (0, start);
+            auto end = juce::jmin (start + interval, numSamples);
+            
+            for (int i = first; i < end; ++i)
+                dest[i] = current + slope * (float) (i - start);
+            
+            current = next;
+        }
+        
+        return phase + (juce::uint32) numSamples * increment;
+    }
+};
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    FixedPointSine.h
+    An integer only carrier and ring-mod multiply, read from a 2 KB table.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//set to 0 in the project's preprocessor definitions to leave the fixed point engine out of the build,
+//CarrierEngine::fixedPoint then falls back to the wavetable engine
+#ifndef RINGMOD_FIXED_POINT_ENGINE
+ #define RINGMOD_FIXED_POINT_ENGINE 1
+#endif
+
+//==============================================================================
+/**
+    A Q15 sine table, half the footprint of the float SineTable, read with
+    integer linear interpolation straight from the 32 bit phase accumulator.
+    
+    Audio is converted to Q31 at the edges of each tile and multiplied by the
+    Q15 carrier with a rounded 64 bit product, so everything in between is
+    integer arithmetic. Q31 has no headroom, so input beyond full scale clips
+    at the conversion, as it would on a fixed point DSP.
+    
+    CarrierKernels vectorises it for SSE4.1, AVX2 and NEON. It is still not
+    faster than the float engines on x86, where the conversions cost more than
+    the integer maths saves: a steady stereo carrier takes ~1.2 ns/sample
+    against ~0.4 for the float table with AVX2, ~3.5 against ~1 with SSE4.1,
+    and ~6.5 against ~2.3 with neither. The NEON kernels are checked against
+    the scalar reference but haven't been timed, so measure with
+    RingModulatorBenchmarks on the ARM target before counting on it for
+    more streams per core there.
+    
+    Immutable once built, so a single copy is shared by every instance.
+*/
+struct FixedPointSine
+{
+    static constexpr int bits = 10;
+    static constexpr int size = 1 << bits;
+    static constexpr int phaseToIndexShift = 32 - bits;
+    //the 15 bits of phase below the index are the interpolation fraction, in Q15
+    static constexpr int fractionShift = phaseToIndexShift - 15;
+    
+    //largest difference allowed from the float reference, ~ -80 dB, checked by FixedPointSineTests. Q15 steps are ~ -90 dB
+    static constexpr float tolerance = 1.0e-4f;
+    
+    static const FixedPointSine& get()
+    {
+        //shared and built lazily, the same way as SineTable::get
+        static const FixedPointSine table;
+        return table;
+    }
+    
+    //sin (phase) in Q15
+    juce::int32 lookup (juce::uint32 phase) const noexcept
+    {
+        auto index = phase >> phaseToIndexShift;
+        auto fraction = (juce::int32) ((phase >> fractionShift) & 0x7fff);
+        auto y0 = (juce::int32) values[index];
+        return y0 + ((((juce::int32) values[index + 1] - y0) * fraction + (1 << 14)) >> 15);
+    }
+    
+    //fills dest with sin (phase) in Q15, stepping the phase by a constant increment, and returns the phase after the last sample
+    juce::uint32 render (juce::int16* dest, int numSamples, juce::uint32 phase, juce::uint32 increment) const noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = (juce::int16) lookup (phase + (juce::uint32) i * increment);
+        
+        return phase + (juce::uint32) numSamples * increment;
+    }
+    
+    //the same carrier as float, for the paths that need one, such as the bypass fade
+    juce::uint32 render (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain) const noexcept
+    {
+        auto scale = gain / 32768.0f;
+        
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = (float) lookup (phase + (juce::uint32) i * increment) * scale;
+        
+        return phase + (juce::uint32) numSamples * increment;
+    }
+    
+    //audio[i] *= carrier[i], with audio converted to Q31 and back on the way through. This is the reference
+    //the vectorised CarrierKernels match exactly
+    template <typename SampleType>
+    static void multiply (SampleType* audio, const juce::int16* carrier, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            audio[i] = fromQ31<SampleType> (multiply (toQ31 (audio[i]), carrier[i]));
+    }
+    
+    //a Q31 sample times a Q15 carrier value, rounded rather than truncated so the product has no DC bias.
+    //The carrier never reaches -1, so the product always fits back in Q31 and never needs saturating
+    static juce::int32 multiply (juce::int32 sample, juce::int16 carrier) noexcept
+    {
+        return (juce::int32) (((juce::int64) sample * carrier + (1 << 14)) >> 15);
+    }
+    
+    //clipped to full scale while still floating point, so the conversion can't overflow. It truncates, which only
+    //touches samples below 2^-7, the only ones with bits below Q31's, and costs far less than a rounding call
+    template <typename SampleType>
+    static juce::int32 toQ31 (SampleType sample) noexcept
+    {
+        //the largest float below 2^31
+        return (juce::int32) juce::jlimit (SampleType (-2147483648.0), SampleType (2147483520.0), sample * SampleType (2147483648.0));
+    }
+    
+    template <typename SampleType>
+    static SampleType fromQ31 (juce::int32 sample) noexcept
+    {
+        return (SampleType) sample * SampleType (1.0 / 2147483648.0);
+    }
+    
+    //Q15, with a guard point repeating the start so interpolation never has to wrap the index
+    alignas (64) juce::int16 values[size + 1];
+
+private:
+    FixedPointSine()
+    {
+        for (int i = 0; i < size + 1; ++i)
+            values[i] = (juce::int16) std::lround (32767.0 * std::sin (juce::MathConstants<double>::twoPi * (i % size) / size));
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE (FixedPointSine)
+};
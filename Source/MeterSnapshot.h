@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    MeterSnapshot.h
+    Block level meter values handed from the audio thread to the GUI.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+struct MeterReading
+{
+    float peak { 0 };
+    float rms { 0 };
+    float carrierFrequency { 0 };
+    //0 at full quality, higher while AdaptiveQuality is saving CPU
+    int qualityLevel { 0 };
+    //seconds of audio processed since prepareToPlay, at the end of the block
+    double blockTime { 0 };
+};
+
+//==============================================================================
+/**
+    A seqlock around a MeterReading. The audio thread publishes once per block
+    without waiting, and readers retry on the rare occasion they overlap a
+    write, so they always see the values from a single block.
+*/
+class MeterSnapshot
+{
+public:
+    //only ever called from one thread at a time
+    void publish (const MeterReading& reading) noexcept
+    {
+        auto sequenceNumber = sequence.load (std::memory_order_relaxed);
+        
+        //odd while the values are being written
+        sequence.store (sequenceNumber + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        
+        peak.store (reading.peak, std::memory_order_relaxed);
+        rms.store (reading.rms, std::memory_order_relaxed);
+        carrierFrequency.store (reading.carrierFrequency, std::memory_order_relaxed);
+        qualityLevel.store (reading.qualityLevel, std::memory_order_relaxed);
+        blockTime.store (reading.blockTime, std::memory_order_relaxed);
+        
+        sequence.store (sequenceNumber + 2, std::memory_order_release);
+    }
+    
+    MeterReading read() const noexcept
+    {
+        MeterReading reading;
+        
+        for (;;)
+        {
+            auto before = sequence.load (std::memory_order_acquire);
+            
+            if ((before & 1) == 0)
+            {
+                reading.peak = peak.load (std::memory_order_relaxed);
+                reading.rms = rms.load (std::memory_order_relaxed);
+                reading.carrierFrequency = carrierFrequency.load (std::memory_order_relaxed);
+                reading.qualityLevel = qualityLevel.load (std::memory_order_relaxed);
+                reading.blockTime = blockTime.load (std::memory_order_relaxed);
+                
+                std::atomic_thread_fence (std::memory_order_acquire);
+                
+                if (sequence.load (std::memory_order_relaxed) == before)
+                    return reading;
+            }
+        }
+    }
+    
+private:
+    std::atomic <juce::uint32> sequence { 0 };
+    std::atomic <float> peak { 0 }, rms { 0 }, carrierFrequency { 0 };
+    std::atomic <int> qualityLevel { 0 };
+    std::atomic <double> blockTime { 0 };
+};
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    PeriodCache.h
+    One rendered period of a steady carrier, streamed instead of re-rendered.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    When period samples of the phase accumulator add up to (nearly) a whole
+    number of cycles, the carrier repeats every period samples. The cache holds
+    one period, rendered once by whichever engine is selected, followed by a
+    copy of its start so that any read of up to maxReadSize samples is
+    contiguous, and the multiply can use it in place.
+    
+    The cache does not own the phase. Each period repeats with a small
+    mismatch to the accumulator, so the cache is rendered again every refill
+    interval, a whole number of periods short enough that the mismatch never
+    adds up to more than maxDrift. The refills fall on multiples of the interval in the caller's
+    sample position, rather than on whenever the last one happened, so the
+    output is the same whatever size of blocks it is read in. Every read is
+    also checked against the real accumulator, and if the phase has jumped,
+    read returns nullptr so the caller renders again.
+    
+    Each streamed sample is rendered at a phase within maxDrift of the exact
+    one. The interpolating engines stay within -100 dB of a fresh render, but
+    the truncating table can land on the neighbouring entry, one table step
+    away, just as a slightly different frequency would.
+    
+    All storage is allocated in prepare.
+*/
+class PeriodCache
+{
+public:
+    //longest period searched for, in samples
+    static constexpr int maxPeriod = 4096;
+    //phase accumulator steps, ~1e-5 radians
+    static constexpr juce::int64 maxDrift = 6836;
+    //a period is only worth caching if at least this many of it play before the drift forces a re-render
+    static constexpr int minPeriodsPerRefill = 4;
+    //even a period that repeats exactly is rendered again after this many of it
+    static constexpr int maxPeriodsPerRefill = 1 << 12;
+    
+    //==============================================================================
+    void prepare (int newMaxReadSize)
+    {
+        maxReadSize = newMaxReadSize;
+        samples.allocate ((size_t) (maxPeriod + maxReadSize), true);
+        invalidate();
+    }
+    
+    void invalidate() noexcept
+    {
+        increment = 0;
+        settings = -1;
+        period = 0;
+        isFilled = false;
+    }
+    
+    //true if a carrier with this increment repeats within maxPeriod samples, and drifts slowly enough that a read
+    //never runs over more than one refill point. Only searches when the increment or render settings change,
+    //which also throws away what was rendered
+    bool setCarrier (juce::uint32 newIncrement, int newSettings) noexcept
+    {
+        if (newIncrement != increment || newSettings != settings)
+        {
+            increment = newIncrement;
+            settings = newSettings;
+            period = findPeriod (increment);
+            refillInterval = period * getPeriodsPerRefill (period, increment);
+            isFilled = false;
+            
+            //refilling more than once per read would render more than it saves
+            if (refillInterval < maxReadSize)
+                period = 0;
+        }
+        
+        return period > 0;
+    }
+    
+    //where to render getRefillLength samples of carrier, starting at getRefillPhase, before calling endRefill. The carrier
+    //is at phase at position, and the cached period starts from the last refill point at or before position
+    float* beginRefill (juce::uint32 phase, juce::int64 position) noexcept
+    {
+        jassert (period > 0 && position >= 0);
+        refillPosition = position - position % refillInterval;
+        refillPhase = phase - (juce::uint32) (position - refillPosition) * increment;
+        isFilled = true;
+        return samples.get();
+    }
+    
+    juce::uint32 getRefillPhase() const noexcept    { return refillPhase; }
+    int getRefillLength() const noexcept            { return period; }
+    
+    //repeats the start of the period after its end, so a read that wraps around the period is still contiguous
+    void endRefill() noexcept
+    {
+        for (int i = 0; i < maxReadSize; ++i)
+            samples[period + i] = samples[i % period];
+    }
+    
+    //how many samples can be read from position before the next refill point
+    int getSamplesUntilRefill (juce::int64 position) const noexcept
+    {
+        jassert (period > 0 && position >= 0);
+        return refillInterval - (int) (position % refillInterval);
+    }
+    
+    //the carrier for numSamples from position, where the accumulator is at phase, or nullptr if it needs rendering again.
+    //Reads can't run past the next refill point
+    const float* read (juce::uint32 phase, juce::int64 position, int numSamples) const noexcept
+    {
+        jassert (numSamples <= maxReadSize);
+        
+        if (! isFilled || position < refillPosition || position + numSamples > refillPosition + refillInterval)
+            return nullptr;
+        
+        auto offset = (int) (position - refillPosition);
+        
+        //a glide or an idle block moved the phase somewhere the cached period didn't
+        if (phase != refillPhase + (juce::uint32) offset * increment)
+            return nullptr;
+        
+        return samples.get() + offset % period;
+    }
+    
+    //the shortest period whose drift leaves room for at least minPeriodsPerRefill periods between renders, or 0 if there isn't one
+    static int findPeriod (juce::uint32 increment) noexcept
+    {
+        for (int candidate = 1; candidate <= maxPeriod; ++candidate)
+        {
+            //how far the accumulator ends up from a whole number of cycles, wrapped to a signed distance
+            auto drift = (juce::int32) ((juce::uint32) candidate * increment);
+            
+            if (std::abs ((juce::int64) drift) * minPeriodsPerRefill <= maxDrift)
+                return candidate;
+        }
+        
+        return 0;
+    }
+    
+    //how many periods play before the accumulator has drifted maxDrift away from the cached one
+    static int getPeriodsPerRefill (int period, juce::uint32 increment) noexcept
+    {
+        auto drift = std::abs ((juce::int64) (juce::int32) ((juce::uint32) period * increment));
+        return drift == 0 ? maxPeriodsPerRefill : (int) juce::jmin ((juce::int64) maxPeriodsPerRefill, maxDrift / drift);
+    }
+
+private:
+    //==============================================================================
+    juce::HeapBlock <float> samples;
+    int maxReadSize { 0 };
+    
+    juce::uint32 increment { 0 };
+    int settings { -1 };
+    int period { 0 };
+    //a whole number of periods
+    int refillInterval { 0 };
+    bool isFilled { false };
+    //the position of the last refill point, and the phase the first cached sample was rendered at
+    juce::int64 refillPosition { 0 };
+    juce::uint32 refillPhase { 0 };
+};
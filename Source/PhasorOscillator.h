@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    PhasorOscillator.h
+    A table free sine carrier made by rotating a unit phasor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Generates sin (phase) by complex rotation, so there are no memory loads in
+    the loop. Several phasors run side by side, one sample apart, and each is
+    rotated by numLanes samples' worth of angle per step, which lets the
+    compiler turn the lane loop into vector code.
+
+    The phasors are rebuilt from the 32 bit phase accumulator at the start of
+    every render, and renormalised every renormaliseInterval samples, so
+    neither the amplitude nor the phase can wander.
+*/
+struct PhasorOscillator
+{
+    static constexpr int numLanes = 4;
+    static constexpr int renormaliseInterval = 256;
+    
+    //renders to the CarrierKernels::RenderFunction contract
+    static juce::uint32 render (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain) noexcept
+    {
+        constexpr double radiansPerStep = juce::MathConstants<double>::twoPi / 4294967296.0;
+        constexpr int groupsPerRenormalise = renormaliseInterval / numLanes;
+        
+        double re[numLanes], im[numLanes];
+        
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            auto angle = radiansPerStep * (double) (juce::uint32) (phase + (juce::uint32) lane * increment);
+            re[lane] = std::cos (angle);
+            im[lane] = std::sin (angle);
+        }
+        
+        auto rotationAngle = radiansPerStep * (double) (juce::uint32) ((juce::uint32) numLanes * increment);
+        auto rotationRe = std::cos (rotationAngle);
+        auto rotationIm = std::sin (rotationAngle);
+        
+        int i = 0;
+        
+        for (int group = 1; i + numLanes <= numSamples; i += numLanes, ++group)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                dest[i + lane] = (float) (im[lane] * gain);
+                
+                auto nextRe = re[lane] * rotationRe - im[lane] * rotationIm;
+                im[lane]    = re[lane] * rotationIm + im[lane] * rotationRe;
+                re[lane]    = nextRe;
+            }
+            
+            if (group % groupsPerRenormalise == 0)
+            {
+                //first order correction towards |z| = 1, plenty when applied this often
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    auto correction = 1.5 - 0.5 * (re[lane] * re[lane] + im[lane] * im[lane]);
+                    re[lane] *= correction;
+                    im[lane] *= correction;
+                }
+            }
+        }
+        
+        //lane n already holds sample i + n, so the tail comes straight out of the phasors
+        for (int lane = 0; i + lane < numSamples; ++lane)
+            dest[i + lane] = (float) (im[lane] * gain);
+        
+        return phase + (juce::uint32) numSamples * increment;
+    }
+};
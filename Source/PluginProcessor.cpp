@@ -1,214 +1,392 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-RingModAudioProcessor::RingModAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
-#endif
-{
-}
-
-RingModAudioProcessor::~RingModAudioProcessor()
-{
-}
-
-//==============================================================================
-const juce::String RingModAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool RingModAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool RingModAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool RingModAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double RingModAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int RingModAudioProcessor::getNumPrograms()
-{
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
-
-int RingModAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void RingModAudioProcessor::setCurrentProgram (int index)
-{
-}
-
-const juce::String RingModAudioProcessor::getProgramName (int index)
-{
-    return {};
-}
-
-void RingModAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-void RingModAudioProcessor::setFequency(float _frequency)
-{
-    frequency = _frequency;
-}
-
-//==============================================================================
-void RingModAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    frequency = 20;
-    waveTableSize = 1024;
-    phase = 0;
-    increment = frequency * waveTableSize / sampleRate;
-    amp = 1.f;
-    
-    for (int i = 0; i < waveTableSize; i++)
-    {
-        waveTable.insert(i, sin(2.0 * juce::MathConstants<double>::pi * i / waveTableSize));
-    }
-    
-    smoothedFrequency.reset(sampleRate, 0.0005);
-}
-
-void RingModAudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool RingModAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-void RingModAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-
-    auto* left = buffer.getWritePointer(0);
-    auto* right = buffer.getWritePointer(1);
-
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-    {
-        if (on)
-        {
-            left[sample] *= waveTable[(int)phase] * amp;
-            right[sample] *= waveTable[(int)phase] * amp;
-            phase = fmod ((phase + increment), waveTableSize);
-            
-            //convert the overall signal from [-1, 1] to [0, 1]
-            float uniPolarSig = (left[sample] + 1) * 0.5;
-            //store inside atomic to be loaded from the GUI thread
-            ap_ColourInterpVal.store(uniPolarSig);
-        }
-        
-        else if (!on)
-        {
-            left[sample] *= amp;
-            right[sample] *= amp;
-        }
-
-    }
-    smoothedFrequency.setTargetValue(frequency);
-    increment = smoothedFrequency.getNextValue() * waveTableSize / getSampleRate();
-}
-
-//==============================================================================
-bool RingModAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* RingModAudioProcessor::createEditor()
-{
-    return new RingModAudioProcessorEditor (*this);
-}
-
-//==============================================================================
-void RingModAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-}
-
-void RingModAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new RingModAudioProcessor();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+RingModAudioProcessor::RingModAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ),
+#else
+     :
+#endif
+       parameters (*this, nullptr, "Parameters", createParameterLayout()),
+       frequencyParameter (parameters.getRawParameterValue ("frequency")),
+       bypassParameter (parameters.getRawParameterValue ("bypass")),
+       oversamplingParameter (parameters.getRawParameterValue ("oversampling")),
+       oversamplingFilterParameter (parameters.getRawParameterValue ("oversamplingFilter"))
+{
+}
+
+RingModAudioProcessor::~RingModAudioProcessor()
+{
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout RingModAudioProcessor::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    
+    //down to 0.05 Hz for tremolo, skewed so the old 20 Hz floor sits in the middle of the dial
+    juce::NormalisableRange<float> frequencyRange (0.05f, 4000.0f, 0.001f);
+    frequencyRange.setSkewForCentre (20.0f);
+    
+    layout.add (std::make_unique<juce::AudioParameterFloat> (juce::ParameterID { "frequency", 1 }, "Frequency",
+                                                             frequencyRange, 20.0f,
+                                                             juce::AudioParameterFloatAttributes().withLabel ("Hz")));
+    layout.add (std::make_unique<juce::AudioParameterBool> (juce::ParameterID { "bypass", 1 }, "Bypass", false));
+    layout.add (std::make_unique<juce::AudioParameterChoice> (juce::ParameterID { "oversampling", 1 }, "Oversampling",
+                                                              juce::StringArray { "Off", "2x", "4x", "8x" }, 0));
+    layout.add (std::make_unique<juce::AudioParameterChoice> (juce::ParameterID { "oversamplingFilter", 1 }, "Oversampling Filter",
+                                                              juce::StringArray { "Linear Phase", "Minimum Phase" }, 0));
+    
+    return layout;
+}
+
+juce::AudioProcessorParameter* RingModAudioProcessor::getBypassParameter() const
+{
+    return parameters.getParameter ("bypass");
+}
+
+//==============================================================================
+const juce::String RingModAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool RingModAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool RingModAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool RingModAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double RingModAudioProcessor::getTailLengthSeconds() const
+{
+    //the oversampling filters are the only thing that rings on after the input stops
+    return getSampleRate() > 0 ? getLatencySamples() / getSampleRate() : 0.0;
+}
+
+int RingModAudioProcessor::getNumPrograms()
+{
+    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int RingModAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void RingModAudioProcessor::setCurrentProgram (int index)
+{
+}
+
+const juce::String RingModAudioProcessor::getProgramName (int index)
+{
+    return {};
+}
+
+void RingModAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+void RingModAudioProcessor::setLogFrequencyGlide (bool shouldGlideLogarithmically)
+{
+    logFrequencyGlide.store (shouldGlideLogarithmically);
+}
+
+void RingModAudioProcessor::setCarrierEngine (CarrierEngine newEngine)
+{
+    carrierEngine.store (newEngine);
+}
+
+void RingModAudioProcessor::setPolynomialAccuracy (PolynomialSine::Accuracy newAccuracy)
+{
+    polynomialAccuracy.store (newAccuracy);
+}
+
+void RingModAudioProcessor::setInterpolation (SineTable::Interpolation newInterpolation)
+{
+    interpolation.store (newInterpolation);
+}
+
+void RingModAudioProcessor::setSharedCarrier (bool shouldShareCarrier)
+{
+    sharedCarrier.store (shouldShareCarrier);
+}
+
+void RingModAudioProcessor::setOfflineQuality (bool shouldUseOfflineQuality)
+{
+    offlineQuality.store (shouldUseOfflineQuality);
+}
+
+void RingModAudioProcessor::setAdaptiveQuality (bool shouldAdaptQuality)
+{
+    adaptiveQuality.store (shouldAdaptQuality);
+}
+
+void RingModAudioProcessor::setCpuBudget (double fractionOfDeadlinePerChannel)
+{
+    qualityGovernor.setBudgetPerChannel (fractionOfDeadlinePerChannel);
+}
+
+int RingModAudioProcessor::getQualityLevel() const
+{
+    return qualityGovernor.getLevel();
+}
+
+template <typename SampleType>
+RingModulator<SampleType>& RingModAudioProcessor::getRingModulator()
+{
+    if constexpr (std::is_same_v<SampleType, double>)
+        return doubleRingModulator;
+    else
+        return floatRingModulator;
+}
+
+template <typename SampleType>
+void RingModAudioProcessor::updateRingModulator (RingModulator<SampleType>& ringModulator)
+{
+    //a bounce has no deadline to meet, so it gets the highest oversampling, the 9th order polynomial evaluated in double,
+    //and hermite reads for glides. Every oversampler was built in prepare, so switching here at a block boundary never allocates
+    auto useOfflineQuality = offlineQuality.load() && isNonRealtime();
+    auto oversamplingOrder = useOfflineQuality ? RingModulator<SampleType>::maxOversamplingOrder : (int) oversamplingParameter->load();
+    auto engine = useOfflineQuality ? CarrierEngine::polynomial : carrierEngine.load();
+    auto accuracy = useOfflineQuality ? PolynomialSine::Accuracy::high : polynomialAccuracy.load();
+    auto interpolationMode = useOfflineQuality ? SineTable::Interpolation::hermite : interpolation.load();
+    //the latency the host is told stays at the order the settings ask for, whatever the quality level below drops to
+    auto latencyOrder = oversamplingOrder;
+    
+    //under CPU pressure the most expensive settings go first: oversampling halves its cost per step, with the input
+    //delayed to keep the latency, then the carrier drops to cheaper interpolation and polynomials, and finally to a plain table read
+    if (auto qualityLevel = qualityGovernor.getLevel(); qualityLevel > 0)
+    {
+        oversamplingOrder = qualityLevel >= 2 ? 0 : juce::jmax (0, oversamplingOrder - 1);
+        
+        if (qualityLevel >= 3)
+        {
+            accuracy = PolynomialSine::Accuracy::low;
+            interpolationMode = juce::jmin (interpolationMode, SineTable::Interpolation::linear);
+        }
+        
+        if (qualityLevel >= 4)
+        {
+            engine = CarrierEngine::wavetable;
+            interpolationMode = SineTable::Interpolation::none;
+        }
+    }
+    
+    //this resets the smoothers for the new rate, so it comes before anything sets their targets.
+    //It crossfades to the new filters itself, the carrier settings below switch cleanly as they all keep the same phase
+    ringModulator.setOversampling (oversamplingOrder, oversamplingFilterParameter->load() >= 0.5f);
+    ringModulator.setLatencyOrder (latencyOrder);
+    ringModulator.setBypassed (bypassParameter->load() >= 0.5f);
+    ringModulator.setLogFrequencyGlide (logFrequencyGlide.load());
+    ringModulator.setCarrierEngine (engine);
+    ringModulator.setPolynomialAccuracy (accuracy);
+    ringModulator.setInterpolation (interpolationMode);
+    ringModulator.setSharedCarrier (sharedCarrier.load());
+    
+    //JUCE hands us parameter changes at block granularity, so they land at the start of the block,
+    //ahead of anything scheduled for the same sample
+    auto parameterFrequency = frequencyParameter->load();
+    
+    if (parameterFrequency != lastFrequencyParameterValue)
+    {
+        lastFrequencyParameterValue = parameterFrequency;
+        ringModulator.setFrequency (parameterFrequency);
+    }
+    
+    //only the oversampling settings and offline rendering move the latency, JUCE only tells the host if it actually changed
+    setLatencySamples (ringModulator.getLatencyInSamples());
+}
+
+//==============================================================================
+void RingModAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    samplesProcessed = 0;
+    lastFrequencyParameterValue = -1.0f;
+    qualityGovernor.reset();
+    
+    juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) juce::jmax (1, samplesPerBlock), (juce::uint32) juce::jmax (1, getTotalNumInputChannels()) };
+    
+    //settings first, so prepare starts the carrier straight at the current frequency and bypass state
+    if (isUsingDoublePrecision())
+    {
+        updateRingModulator (doubleRingModulator);
+        doubleRingModulator.prepare (spec);
+    }
+    else
+    {
+        updateRingModulator (floatRingModulator);
+        floatRingModulator.prepare (spec);
+    }
+    
+    //prepare is what builds the oversamplers, so the latency is only known now
+    setLatencySamples (isUsingDoublePrecision() ? doubleRingModulator.getLatencyInSamples() : floatRingModulator.getLatencyInSamples());
+}
+
+void RingModAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool RingModAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    // The same carrier is applied to every channel, so any layout works,
+    // from mono through surround and discrete multichannel, as long as
+    // there is at least one channel.
+    if (layouts.getMainOutputChannelSet().isDisabled())
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+bool RingModAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void RingModAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer);
+}
+
+void RingModAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer);
+}
+
+template <typename SampleType>
+void RingModAudioProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    auto numSamples = buffer.getNumSamples();
+    auto numChannels = juce::jmin (totalNumInputChannels, buffer.getNumChannels());
+    auto& ringModulator = getRingModulator<SampleType>();
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    
+    //parameters are read once per block
+    updateRingModulator (ringModulator);
+    
+    //a shared carrier lines its phase up with the host timeline, which only means something while the transport runs.
+    //The play head can only be asked from inside processBlock, so this isn't part of updateRingModulator
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition(); position.hasValue() && position->getIsPlaying())
+            if (auto timeInSamples = position->getTimeInSamples(); timeInSamples.hasValue())
+                ringModulator.setTimelinePosition (*timeInSamples);
+    
+    auto block = juce::dsp::AudioBlock<SampleType> (buffer).getSubsetChannelBlock (0, (size_t) numChannels);
+    ringModulator.process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+    
+    //offline there is no deadline to miss, and the time a bounce takes says nothing about live headroom
+    if (adaptiveQuality.load() && ! isNonRealtime())
+        qualityGovernor.update (juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks), numSamples, numChannels, getSampleRate());
+    else if (qualityGovernor.getLevel() != 0)
+        qualityGovernor.reset();
+    
+    //one meter reading per block rather than a store per sample
+    MeterReading reading;
+    
+    //an idle block came out silent, so there is nothing to measure
+    for (int channel = 0; channel < numChannels && ! ringModulator.isIdle(); ++channel)
+    {
+        reading.peak = juce::jmax (reading.peak, (float) buffer.getMagnitude (channel, 0, numSamples));
+        auto channelRms = (float) buffer.getRMSLevel (channel, 0, numSamples);
+        reading.rms += channelRms * channelRms;
+    }
+    
+    reading.rms = numChannels > 0 ? std::sqrt (reading.rms / (float) numChannels) : 0.0f;
+    reading.carrierFrequency = (float) ringModulator.getCurrentFrequency();
+    reading.qualityLevel = qualityGovernor.getLevel();
+    samplesProcessed += numSamples;
+    reading.blockTime = (double) samplesProcessed / getSampleRate();
+    meter.publish (reading);
+}
+
+//==============================================================================
+bool RingModAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* RingModAudioProcessor::createEditor()
+{
+    return new RingModAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+void RingModAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    auto state = parameters.copyState();
+    std::unique_ptr<juce::XmlElement> xml (state.createXml());
+    copyXmlToBinary (*xml, destData);
+}
+
+void RingModAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    std::unique_ptr<juce::XmlElement> xml (getXmlFromBinary (data, sizeInBytes));
+    
+    if (xml != nullptr && xml->hasTagName (parameters.state.getType()))
+        parameters.replaceState (juce::ValueTree::fromXml (*xml));
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new RingModAudioProcessor();
+}
@@ -1,74 +1,126 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-//==============================================================================
-/**
-*/
-class RingModAudioProcessor  : public juce::AudioProcessor
-                            #if JucePlugin_Enable_ARA
-                             , public juce::AudioProcessorARAExtension
-                            #endif
-{
-public:
-    //==============================================================================
-    RingModAudioProcessor();
-    ~RingModAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-    void setFequency (float _frequency);
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-    
-    double frequency;
-    std::atomic <float> ap_ColourInterpVal { 0 };
-    bool on { true };
-
-private:
-    juce::Array <float> waveTable;
-    double waveTableSize;
-    double phase;
-    double increment;
-    float amp;
-    juce::LinearSmoothedValue <float> smoothedFrequency { 20 };
-    
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RingModAudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RingModulator.h"
+#include "MeterSnapshot.h"
+#include "AdaptiveQuality.h"
+
+//==============================================================================
+/**
+*/
+class RingModAudioProcessor  : public juce::AudioProcessor
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    RingModAudioProcessor();
+    ~RingModAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    juce::AudioProcessorParameter* getBypassParameter() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+    //glide the frequency dial in octaves rather than hertz, so sweeps sound even across the range
+    void setLogFrequencyGlide (bool shouldGlideLogarithmically);
+    void setCarrierEngine (CarrierEngine newEngine);
+    //only used by the polynomial engine
+    void setPolynomialAccuracy (PolynomialSine::Accuracy newAccuracy);
+    //only used by the wavetable engine
+    void setInterpolation (SineTable::Interpolation newInterpolation);
+    //share carrier renders with every other instance in the process that is playing the same frequency. Off by default
+    void setSharedCarrier (bool shouldShareCarrier);
+    //while the host renders offline, ignore the settings above and the oversampling parameter and use the most
+    //accurate of everything. On by default
+    void setOfflineQuality (bool shouldUseOfflineQuality);
+    //step the oversampling, interpolation and engine down while blocks take more than the CPU budget, and back up
+    //once there is headroom again. Off by default, as the budget below has to be checked against this machine first
+    void setAdaptiveQuality (bool shouldAdaptQuality);
+    //the fraction of each block's duration this instance may take for each channel before adaptive quality steps down.
+    //2.5% per channel by default, see AdaptiveQuality. Safe from any thread
+    void setCpuBudget (double fractionOfDeadlinePerChannel);
+    //0 at the quality the settings ask for, up to AdaptiveQuality::maxLevel at the cheapest. Safe from any thread
+    int getQualityLevel() const;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+    
+    //host visible, automatable parameters. The editor attaches to these rather than touching the processor directly
+    juce::AudioProcessorValueTreeState parameters;
+    //published once per block for the GUI
+    MeterSnapshot meter;
+
+private:
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    //float and double processing share one source, each with its own RingModulator
+    template <typename SampleType>
+    void processSamples (juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    RingModulator<SampleType>& getRingModulator();
+    //pushes the parameters and settings into the ring modulator, once per block
+    template <typename SampleType>
+    void updateRingModulator (RingModulator<SampleType>& ringModulator);
+    
+    //each value lives inside its own heap allocated parameter, so the audio thread's reads never share a cache line with another parameter
+    std::atomic <float>* frequencyParameter;
+    std::atomic <float>* bypassParameter;
+    std::atomic <float>* oversamplingParameter;
+    std::atomic <float>* oversamplingFilterParameter;
+    
+    //only the one matching the host's processing precision gets prepared
+    RingModulator <float> floatRingModulator;
+    RingModulator <double> doubleRingModulator;
+    
+    juce::int64 samplesProcessed { 0 };
+    //settings the GUI or host side may change from any thread, handed to the ring modulator at the start of each block
+    std::atomic <bool> logFrequencyGlide { false };
+    std::atomic <CarrierEngine> carrierEngine { CarrierEngine::wavetable };
+    std::atomic <PolynomialSine::Accuracy> polynomialAccuracy { PolynomialSine::Accuracy::medium };
+    std::atomic <SineTable::Interpolation> interpolation { SineTable::Interpolation::none };
+    std::atomic <bool> sharedCarrier { false };
+    std::atomic <bool> offlineQuality { true };
+    std::atomic <bool> adaptiveQuality { false };
+    //only updated from the audio thread
+    AdaptiveQuality qualityGovernor;
+    float lastFrequencyParameterValue { -1.0f };
+    
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RingModAudioProcessor)
+};
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    PolynomialSine.h
+    A table free sine carrier from odd minimax polynomials.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Evaluates sin (phase) with an odd minimax polynomial over a quarter cycle.
+    The phase is folded into [-1/4, 1/4] of a cycle without branching, so
+    each sample is independent of the others and the render loop vectorises
+    with no table gathers.
+
+    Peak errors against a true sine, measured on the float output:
+        low     5th order   ~ -83 dB
+        medium  7th order   ~ -122 dB
+        high    9th order   ~ -147 dB, evaluated in double and limited by the float result
+*/
+struct PolynomialSine
+{
+    enum class Accuracy
+    {
+        low,
+        medium,
+        high
+    };
+    
+    template <Accuracy accuracy>
+    static float evaluate (juce::uint32 phase) noexcept
+    {
+        if constexpr (accuracy == Accuracy::high)
+        {
+            auto x = fold ((double) (juce::int32) phase * (1.0 / 4294967296.0));
+            auto x2 = x * x;
+            return (float) (x * (6.2831853019 + x2 * (-41.341691864 + x2 * (81.603265729 + x2 * (-76.598207920 + x2 * 39.873231778)))));
+        }
+        else if constexpr (accuracy == Accuracy::medium)
+        {
+            auto x = fold ((float) (juce::int32) phase * (1.0f / 4294967296.0f));
+            auto x2 = x * x;
+            return x * (6.28316404f + x2 * (-41.3371424f + x2 * (81.3407689f + x2 * -70.9934333f)));
+        }
+        else
+        {
+            auto x = fold ((float) (juce::int32) phase * (1.0f / 4294967296.0f));
+            auto x2 = x * x;
+            return x * (6.28128008f + x2 * (-41.0952427f + x2 * 73.5855148f));
+        }
+    }
+    
+    //renders to the CarrierKernels::RenderFunction contract
+    template <Accuracy accuracy>
+    static juce::uint32 render (float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = evaluate<accuracy> (phase + (juce::uint32) i * increment) * gain;
+        
+        return phase + (juce::uint32) numSamples * increment;
+    }
+    
+    static juce::uint32 render (Accuracy accuracy, float* dest, int numSamples, juce::uint32 phase, juce::uint32 increment, float gain) noexcept
+    {
+        switch (accuracy)
+        {
+            case Accuracy::high:    return render<Accuracy::high>   (dest, numSamples, phase, increment, gain);
+            case Accuracy::medium:  return render<Accuracy::medium> (dest, numSamples, phase, increment, gain);
+            case Accuracy::low:     break;
+        }
+        
+        return render<Accuracy::low> (dest, numSamples, phase, increment, gain);
+    }
+    
+private:
+    //maps a phase in [-1/2, 1/2) cycles onto [-1/4, 1/4] with the same sine
+    template <typename FloatType>
+    static FloatType fold (FloatType cycles) noexcept
+    {
+        auto magnitude = std::abs (cycles);
+        return std::copysign (juce::jmin (magnitude, (FloatType) 0.5 - magnitude), cycles);
+    }
+};
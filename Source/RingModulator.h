@@ -0,0 +1,938 @@
+/*
+  ==============================================================================
+
+    RingModulator.h
+    The ring modulator itself, as a juce::dsp processor with no plugin wrapper.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SineTable.h"
+#include "CarrierKernels.h"
+#include "PhasorOscillator.h"
+#include "PolynomialSine.h"
+#include "ControlRateSine.h"
+#include "PeriodCache.h"
+#include "SharedCarrier.h"
+#include "FixedPointSine.h"
+
+//how the sine carrier is produced
+enum class CarrierEngine
+{
+    wavetable,
+    phasor,
+    polynomial,
+    //integer arithmetic throughout, see FixedPointSine. The wavetable engine stands in when built without it
+    fixedPoint
+};
+
+//==============================================================================
+/**
+    Multiplies its input by a sine carrier. Follows the juce::dsp processor
+    contract (prepare, process, reset), so it can sit in a ProcessorChain next
+    to other stages. It and everything it uses are headers only, so including
+    RingModulator.h is all a project needs beyond the JUCE modules.
+    
+    The carrier is always rendered in float by the CarrierKernels, whatever
+    SampleType is, and widened when processing doubles.
+    
+    Like the juce::dsp processors, none of this is thread safe. Call the
+    setters from the audio thread before process, or while nothing is
+    processing.
+*/
+template <typename SampleType>
+class RingModulator
+{
+public:
+    //2x, 4x and 8x for each of linear phase FIR and minimum phase IIR half-band filters, all built in prepare
+    static constexpr int maxOversamplingOrder = 3;
+    //the most frequency changes that can be scheduled for a single process call
+    static constexpr int maxFrequencyChangesPerBlock = 64;
+    
+    //==============================================================================
+    RingModulator() = default;
+    
+    //==============================================================================
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = spec.sampleRate;
+        maximumBlockSize = (int) juce::jmax ((juce::uint32) 1, spec.maximumBlockSize);
+        
+        //every factor and filter type is built up front, so changing the oversampling never allocates on the audio thread
+        auto numChannels = (size_t) juce::jmax ((juce::uint32) 1, spec.numChannels);
+        
+        for (int filter = 0; filter < 2; ++filter)
+        {
+            auto filterType = filter == 0 ? juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple
+                                          : juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR;
+            
+            for (int order = 1; order <= maxOversamplingOrder; ++order)
+            {
+                auto& stage = oversamplers[filter][order - 1];
+                stage = std::make_unique<juce::dsp::Oversampling<SampleType>> (numChannels, (size_t) order, filterType, true, true);
+                stage->initProcessing ((size_t) maximumBlockSize);
+                latencies[filter][order] = juce::roundToInt (stage->getLatencyInSamples());
+            }
+        }
+        
+        //enough input to delay a piece by the longest latency any path could be padded to
+        auto longestLatency = juce::jmax (latencies[0][maxOversamplingOrder], latencies[1][maxOversamplingOrder]);
+        inputHistory.setSize ((int) numChannels, longestLatency + maximumBlockSize);
+        
+        kernels = CarrierKernels::getKernels (CarrierKernels::getBestSupportedInstructionSet());
+        
+        //scratch space for one tile of carrier, shared by every channel
+        carrierBuffer.setSize (1, carrierTileSize);
+        crossfadeBuffer.setSize ((int) numChannels, maximumBlockSize);
+        periodCache.prepare (carrierTileSize);
+        
+        if constexpr (std::is_same_v<SampleType, double>)
+            doubleCarrier.allocate ((size_t) carrierTileSize, true);
+        
+        glideIncrements.allocate ((size_t) carrierTileSize, true);
+       
+       #if RINGMOD_FIXED_POINT_ENGINE
+        fixedPointCarrier.allocate ((size_t) carrierTileSize, true);
+       #endif
+       
+        updateOversampling();
+        reset();
+    }
+    
+    //starts the carrier from zero phase, with the frequency and bypass fade jumped straight to their targets
+    void reset() noexcept
+    {
+        phase = 0;
+        carrierPosition = 0;
+        silentSamples = 0;
+        numFrequencyChanges = 0;
+        expectedTimelinePosition = -1;
+        hasTimelinePosition = false;
+        isCrossfading = false;
+        inputHistory.clear();
+        historyWritePosition = 0;
+        isDry = bypassed && getLatencyInSamples() > 0;
+        wetMix.setCurrentAndTargetValue (wetMix.getTargetValue());
+        smoothedFrequency.setCurrentAndTargetValue (smoothedFrequency.getTargetValue());
+        
+        if (activeOversampler != nullptr)
+            activeOversampler->reset();
+    }
+    
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        auto&& inputBlock = context.getInputBlock();
+        auto&& outputBlock = context.getOutputBlock();
+        
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples() == outputBlock.getNumSamples());
+        
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom (inputBlock);
+        
+        auto numSamples = (int) outputBlock.getNumSamples();
+        
+        //a bypassed context fades out like the bypass setter does, so a ProcessorChain can bypass this stage without clicks
+        wetMix.setTargetValue (bypassed || context.isBypassed ? 0.0f : 1.0f);
+        //once the fade out has finished, a bypassed block does no carrier work at all
+        auto isFullyBypassed = ! wetMix.isSmoothing() && wetMix.getTargetValue() == 0.0f;
+        
+        //nor does it need the filters, the input read back as late as they would have let it through lines up with the rest
+        if (auto shouldBeDry = isFullyBypassed && getLatencyInSamples() > 0; shouldBeDry != isDry)
+        {
+            beginCrossfade();
+            isDry = shouldBeDry;
+            
+            //the filters sat the bypass out, so they start again from silence and are faded in
+            if (! isDry && activeOversampler != nullptr)
+                activeOversampler->reset();
+            
+            endCrossfadeIfUnchanged();
+        }
+        
+        //instances sharing a carrier take their phase from the host timeline whenever playback starts or jumps,
+        //which puts every instance playing the same frequency in lockstep
+        if (shareCarrier && hasTimelinePosition)
+        {
+            if (timelinePosition != expectedTimelinePosition)
+            {
+                carrierPosition = timelinePosition * (1 << oversamplingOrder);
+                phase = (juce::uint32) carrierPosition * frequencyToIncrement (fromGlideDomain (smoothedFrequency.getTargetValue()));
+            }
+            
+            expectedTimelinePosition = timelinePosition + numSamples;
+        }
+        else
+        {
+            expectedTimelinePosition = -1;
+        }
+        
+        hasTimelinePosition = false;
+        
+        //the history is only kept while something may read it late, and starts from silence rather than whatever it held last time
+        auto keepsInputHistory = isKeepingInputHistory();
+        
+        if (keepsInputHistory && ! wasKeepingInputHistory)
+            inputHistory.clear();
+        
+        wasKeepingInputHistory = keepsInputHistory;
+        
+        //silence in gives silence out, so once nothing is left ringing in the oversampling filters only the phase has to move on
+        auto isSilentBlock = isSilent (outputBlock);
+        silentSamples = isSilentBlock ? silentSamples + numSamples : 0;
+        
+        //a padded or dry path is still playing out input from before the silence started
+        auto longestInputDelay = juce::jmax (getPathDelay(), isCrossfading ? outgoingInputDelay : 0);
+        
+        idle = isSilentBlock && silentSamples - numSamples >= silenceTailSamples + longestInputDelay
+                && numFrequencyChanges == 0 && ! smoothedFrequency.isSmoothing() && ! wetMix.isSmoothing();
+        
+        int changeIndex = 0;
+        
+        if (idle)
+        {
+            //nothing has come out of either filter path for a while, so there is nothing to fade
+            isCrossfading = false;
+            
+            //once the history holds nothing but silence, pushing more of it changes nothing
+            if (keepsInputHistory && silentSamples - numSamples < inputHistory.getNumSamples())
+                pushInputHistory (outputBlock);
+            
+            //the engines all step the phase by a constant increment, so jumping it ahead leaves the carrier exactly where rendering would have
+            carrierPosition += numSamples * (1 << oversamplingOrder);
+            phase += (juce::uint32) (numSamples * (1 << oversamplingOrder)) * frequencyToIncrement (fromGlideDomain (smoothedFrequency.getTargetValue()));
+        }
+        else
+        {
+            auto renderer = getSegmentRenderer (isFullyBypassed, carrierEngine, (int) outputBlock.getNumChannels());
+            
+            //the oversamplers are sized from prepare, so bigger blocks are worked through in pieces
+            for (int pieceStart = 0; pieceStart < numSamples; pieceStart += maximumBlockSize)
+            {
+                auto pieceSize = juce::jmin (maximumBlockSize, numSamples - pieceStart);
+                auto piece = outputBlock.getSubBlock ((size_t) pieceStart, (size_t) pieceSize);
+                
+                if (keepsInputHistory)
+                    pushInputHistory (piece);
+                
+                if (isCrossfading)
+                {
+                    crossfadePiece (piece, pieceStart, changeIndex, renderer);
+                }
+                else
+                {
+                    if (getPathDelay() > 0)
+                        readInputHistory (piece, getPathDelay());
+                    
+                    if (isDry)
+                        skipPiece (pieceStart, pieceSize, changeIndex);
+                    else
+                        processPiece (piece, pieceStart, changeIndex, renderer);
+                }
+            }
+        }
+        
+        //anything scheduled past the end of this block still becomes the new target
+        while (changeIndex < numFrequencyChanges)
+            smoothedFrequency.setTargetValue (toGlideDomain (frequencyChanges[(size_t) changeIndex++].frequency));
+        
+        numFrequencyChanges = 0;
+    }
+    
+    //==============================================================================
+    //glides to the new frequency from the start of the next process call, ahead of anything scheduled for the same sample
+    void setFrequency (float frequencyInHz) noexcept
+    {
+        smoothedFrequency.setTargetValue (toGlideDomain (frequencyInHz));
+    }
+    
+    //for callers that know where in the next block a frequency change belongs, e.g. a host graph delivering
+    //automation with sample offsets. The offset is relative to the start of the next process call
+    void scheduleFrequencyChange (int sampleOffset, float frequencyInHz) noexcept
+    {
+        sampleOffset = juce::jmax (0, sampleOffset);
+        
+        //kept sorted by offset as they arrive, changes at the same offset stay in the order they were made
+        if (numFrequencyChanges == maxFrequencyChangesPerBlock)
+        {
+            //out of room, so the newest change replaces the last one rather than allocating
+            jassertfalse;
+            --numFrequencyChanges;
+        }
+        
+        auto insertIndex = numFrequencyChanges;
+        
+        while (insertIndex > 0 && frequencyChanges[(size_t) insertIndex - 1].sampleOffset > sampleOffset)
+        {
+            frequencyChanges[(size_t) insertIndex] = frequencyChanges[(size_t) insertIndex - 1];
+            --insertIndex;
+        }
+        
+        frequencyChanges[(size_t) insertIndex] = { sampleOffset, frequencyInHz };
+        ++numFrequencyChanges;
+    }
+    
+    //fades between ring modulated and dry over 10 ms rather than switching, so toggling doesn't click
+    void setBypassed (bool shouldBeBypassed) noexcept
+    {
+        bypassed = shouldBeBypassed;
+        wetMix.setTargetValue (bypassed ? 0.0f : 1.0f);
+    }
+    
+    //order 0 is off, 1 to 3 are 2x to 4x to 8x. Switching resets the glide and the bypass fade for the new rate,
+    //so call this before setFrequency and setBypassed. The next process call crossfades from the old filters to the new ones.
+    //The filters cost far more than the carrier, RingModulatorBenchmarks in the test project measures each factor and filter type
+    void setOversampling (int newOrder, bool useMinimumPhaseFilter) noexcept
+    {
+        newOrder = juce::jlimit (0, maxOversamplingOrder, newOrder);
+        auto newFilter = useMinimumPhaseFilter ? 1 : 0;
+        
+        if (newOrder != oversamplingOrder || newFilter != oversamplingFilter)
+        {
+            beginCrossfade();
+            oversamplingOrder = newOrder;
+            oversamplingFilter = newFilter;
+            updateOversampling();
+            endCrossfadeIfUnchanged();
+        }
+    }
+    
+    //the oversampling order whose latency getLatencyInSamples reports. Lower orders read their input that much later,
+    //so dropping the oversampling to save CPU doesn't move the latency the host compensates for. 0, the default, never pads
+    void setLatencyOrder (int newOrder) noexcept
+    {
+        newOrder = juce::jlimit (0, maxOversamplingOrder, newOrder);
+        
+        if (newOrder != latencyOrder)
+        {
+            beginCrossfade();
+            latencyOrder = newOrder;
+            updateInputDelay();
+            endCrossfadeIfUnchanged();
+        }
+    }
+    
+    //glide the frequency in octaves rather than hertz, so sweeps sound even across the range
+    void setLogFrequencyGlide (bool shouldGlideLogarithmically) noexcept
+    {
+        if (shouldGlideLogarithmically == glideIsLogarithmic)
+            return;
+        
+        //switching glide domain mid-glide carries on from wherever the carrier currently is
+        auto currentFrequency = fromGlideDomain (smoothedFrequency.getCurrentValue());
+        auto targetFrequency = fromGlideDomain (smoothedFrequency.getTargetValue());
+        glideIsLogarithmic = shouldGlideLogarithmically;
+        smoothedFrequency.setCurrentAndTargetValue (toGlideDomain (currentFrequency));
+        smoothedFrequency.setTargetValue (toGlideDomain (targetFrequency));
+    }
+    
+    void setCarrierEngine (CarrierEngine newEngine) noexcept
+    {
+       #if ! RINGMOD_FIXED_POINT_ENGINE
+        if (newEngine == CarrierEngine::fixedPoint)
+            newEngine = CarrierEngine::wavetable;
+       #endif
+       
+        carrierEngine = newEngine;
+    }
+    
+    //only used by the polynomial engine
+    void setPolynomialAccuracy (PolynomialSine::Accuracy newAccuracy) noexcept      { polynomialAccuracy = newAccuracy; }
+    //only used by the wavetable engine
+    void setInterpolation (SineTable::Interpolation newInterpolation) noexcept      { interpolation = newInterpolation; }
+    
+    //opt in to the process wide SharedCarrier, so instances at the same frequency and phase render each tile once between them
+    void setSharedCarrier (bool shouldShareCarrier) noexcept                        { shareCarrier = shouldShareCarrier; }
+    
+    //the host timeline position of the next process call, while the transport is playing. Only used with a shared carrier,
+    //to line the phase up with other instances
+    void setTimelinePosition (juce::int64 samplePosition) noexcept
+    {
+        timelinePosition = samplePosition;
+        hasTimelinePosition = true;
+    }
+    
+    //==============================================================================
+    //the delay added by the oversampling filters and any padding up to the latency order, 0 with both off
+    int getLatencyInSamples() const noexcept
+    {
+        return latencies[oversamplingFilter][oversamplingOrder] + inputDelay;
+    }
+    
+    //where the glide has got to, in hertz
+    double getCurrentFrequency() const noexcept             { return fromGlideDomain (smoothedFrequency.getCurrentValue()); }
+    
+    //true if the last process call was silent all the way through and skipped the carrier entirely
+    bool isIdle() const noexcept                            { return idle; }
+
+private:
+    //==============================================================================
+    struct FrequencyChange
+    {
+        int sampleOffset;
+        float frequency;
+    };
+    
+    //renders and applies the carrier over part of a block, or just moves the glide on when fully bypassed
+    using SegmentRenderer = void (RingModulator::*) (const juce::dsp::AudioBlock<SampleType>&, int, int);
+    
+    //==============================================================================
+    void processPiece (const juce::dsp::AudioBlock<SampleType>& block, int pieceStart, int& changeIndex, SegmentRenderer renderer)
+    {
+        //with oversampling on, the carrier and the multiply run at the higher rate, in between the up and down sampling filters
+        auto processingBlock = activeOversampler != nullptr ? activeOversampler->processSamplesUp (block) : block;
+        auto numProcessingSamples = (int) processingBlock.getNumSamples();
+        
+        auto toProcessingOffset = [this, pieceStart] (int sampleOffset) { return (sampleOffset - pieceStart) * (1 << oversamplingOrder); };
+        
+        //render in segments between frequency changes so each one lands on its exact sample
+        for (int segmentStart = 0; segmentStart < numProcessingSamples;)
+        {
+            while (changeIndex < numFrequencyChanges && toProcessingOffset (frequencyChanges[(size_t) changeIndex].sampleOffset) <= segmentStart)
+                smoothedFrequency.setTargetValue (toGlideDomain (frequencyChanges[(size_t) changeIndex++].frequency));
+            
+            auto segmentEnd = changeIndex < numFrequencyChanges ? juce::jmin (numProcessingSamples, toProcessingOffset (frequencyChanges[(size_t) changeIndex].sampleOffset))
+                                                                : numProcessingSamples;
+            
+            (this->*renderer) (processingBlock, segmentStart, segmentEnd - segmentStart);
+            
+            segmentStart = segmentEnd;
+        }
+        
+        //the bypass fade still goes through the filters, it's only once fully bypassed that the dry path takes over
+        if (activeOversampler != nullptr)
+            activeOversampler->processSamplesDown (block);
+    }
+    
+    //runs the piece through the old oversampling as well as the new, and fades from one to the other across it.
+    //Unless both are padded to the latency order the two paths have different latencies, so the fade briefly combs,
+    //which is far quieter than the step a hard switch leaves
+    void crossfadePiece (const juce::dsp::AudioBlock<SampleType>& block, int pieceStart, int& changeIndex, SegmentRenderer renderer)
+    {
+        isCrossfading = false;
+        
+        auto numSamples = block.getNumSamples();
+        auto outgoingBlock = juce::dsp::AudioBlock<SampleType> (crossfadeBuffer).getSubsetChannelBlock (0, block.getNumChannels())
+                                                                                   .getSubBlock (0, numSamples);
+        readInputHistory (outgoingBlock, outgoingInputDelay);
+        readInputHistory (block, getPathDelay());
+        
+        //both paths are dry, or only the padding changed and one set of filters can't run both, so the fade happens on the way in instead
+        if (outgoingIsDry == isDry && (isDry || outgoingOversampler == activeOversampler))
+        {
+            fadeBetween (outgoingBlock, block);
+            
+            if (isDry)
+                skipPiece (pieceStart, (int) numSamples, changeIndex);
+            else
+                processPiece (block, pieceStart, changeIndex, renderer);
+            
+            return;
+        }
+        
+        //the outgoing path renders from the same carrier state, which is put back for the new path afterwards
+        auto startPhase = phase;
+        auto startPosition = carrierPosition;
+        auto startFrequency = smoothedFrequency;
+        auto startWetMix = wetMix;
+        auto startChangeIndex = changeIndex;
+        
+        //a dry outgoing path is already what was read back from the history
+        if (! outgoingIsDry)
+        {
+            std::swap (activeOversampler, outgoingOversampler);
+            std::swap (oversamplingOrder, outgoingOrder);
+            processingSampleRate = sampleRate * (1 << oversamplingOrder);
+            processPiece (outgoingBlock, pieceStart, changeIndex, renderer);
+            
+            std::swap (activeOversampler, outgoingOversampler);
+            std::swap (oversamplingOrder, outgoingOrder);
+            processingSampleRate = sampleRate * (1 << oversamplingOrder);
+        }
+        
+        phase = startPhase;
+        carrierPosition = startPosition;
+        smoothedFrequency = startFrequency;
+        wetMix = startWetMix;
+        changeIndex = startChangeIndex;
+        
+        if (isDry)
+            skipPiece (pieceStart, (int) numSamples, changeIndex);
+        else
+            processPiece (block, pieceStart, changeIndex, renderer);
+        
+        //the new filters start from silence, and are faded in as they fill
+        fadeBetween (outgoingBlock, block);
+    }
+    
+    //a piece that skips the filters as well as the carrier still moves the glide on, with every frequency change landing on its sample
+    void skipPiece (int pieceStart, int numSamples, int& changeIndex) noexcept
+    {
+        auto factor = 1 << oversamplingOrder;
+        auto position = pieceStart;
+        auto pieceEnd = pieceStart + numSamples;
+        
+        while (changeIndex < numFrequencyChanges && frequencyChanges[(size_t) changeIndex].sampleOffset < pieceEnd)
+        {
+            auto changeOffset = juce::jmax (position, frequencyChanges[(size_t) changeIndex].sampleOffset);
+            smoothedFrequency.skip ((changeOffset - position) * factor);
+            position = changeOffset;
+            smoothedFrequency.setTargetValue (toGlideDomain (frequencyChanges[(size_t) changeIndex++].frequency));
+        }
+        
+        smoothedFrequency.skip ((pieceEnd - position) * factor);
+    }
+    
+    //a linear fade across the block from outgoing to incoming, left in incoming
+    static void fadeBetween (const juce::dsp::AudioBlock<SampleType>& outgoingBlock, const juce::dsp::AudioBlock<SampleType>& incomingBlock) noexcept
+    {
+        auto numSamples = incomingBlock.getNumSamples();
+        
+        for (size_t channel = 0; channel < incomingBlock.getNumChannels(); ++channel)
+        {
+            auto* incoming = incomingBlock.getChannelPointer (channel);
+            auto* outgoing = outgoingBlock.getChannelPointer (channel);
+            
+            for (size_t sample = 0; sample < numSamples; ++sample)
+            {
+                auto fade = (SampleType) (sample + 1) / (SampleType) numSamples;
+                incoming[sample] = outgoing[sample] + fade * (incoming[sample] - outgoing[sample]);
+            }
+        }
+    }
+    
+    //several switches before the next process call still fade from whatever was last heard
+    void beginCrossfade() noexcept
+    {
+        if (! isCrossfading)
+        {
+            outgoingOversampler = activeOversampler;
+            outgoingOrder = oversamplingOrder;
+            outgoingInputDelay = getPathDelay();
+            outgoingIsDry = isDry;
+            isCrossfading = true;
+        }
+    }
+    
+    void endCrossfadeIfUnchanged() noexcept
+    {
+        //switched straight back, whose filters the reset has just cleared, or oversampling was off both times, so there is nothing to fade from
+        if (outgoingIsDry == isDry && outgoingInputDelay == getPathDelay() && (isDry || outgoingOversampler == activeOversampler))
+            isCrossfading = false;
+    }
+    
+    //a padded path reads its input late, and so does the dry path, which needs the history from the start of the bypass fade.
+    //A crossfade may be fading from or to either
+    bool isKeepingInputHistory() const noexcept
+    {
+        return latencyOrder > 0 || isCrossfading || isDry || (wetMix.getTargetValue() == 0.0f && getLatencyInSamples() > 0);
+    }
+    
+    //how late the current path reads its input, the padding, or the whole latency for the dry path
+    int getPathDelay() const noexcept
+    {
+        return isDry ? getLatencyInSamples() : inputDelay;
+    }
+    
+    //keeps the most recent input, so a padded path can read its pieces back late
+    void pushInputHistory (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        jassert (block.getNumChannels() <= (size_t) inputHistory.getNumChannels());
+        
+        auto historySize = inputHistory.getNumSamples();
+        auto numSamples = (int) block.getNumSamples();
+        //anything further back than the history holds would only be overwritten again, which long idle blocks rely on
+        auto firstSample = juce::jmax (0, numSamples - historySize);
+        historyWritePosition = (historyWritePosition + firstSample) % historySize;
+        
+        for (int sample = firstSample; sample < numSamples;)
+        {
+            auto chunkSize = juce::jmin (numSamples - sample, historySize - historyWritePosition);
+            
+            for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+                juce::FloatVectorOperations::copy (inputHistory.getWritePointer ((int) channel, historyWritePosition), block.getChannelPointer (channel) + sample, chunkSize);
+            
+            sample += chunkSize;
+            historyWritePosition = (historyWritePosition + chunkSize) % historySize;
+        }
+    }
+    
+    //the piece that was just pushed, delayedBy samples late
+    void readInputHistory (const juce::dsp::AudioBlock<SampleType>& block, int delayedBy) const noexcept
+    {
+        auto historySize = inputHistory.getNumSamples();
+        auto numSamples = (int) block.getNumSamples();
+        jassert (numSamples + delayedBy <= historySize);
+        
+        auto readPosition = (historyWritePosition - numSamples - delayedBy + 2 * historySize) % historySize;
+        
+        for (int sample = 0; sample < numSamples;)
+        {
+            auto chunkSize = juce::jmin (numSamples - sample, historySize - readPosition);
+            
+            for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+                juce::FloatVectorOperations::copy (block.getChannelPointer (channel) + sample, inputHistory.getReadPointer ((int) channel, readPosition), chunkSize);
+            
+            sample += chunkSize;
+            readPosition = (readPosition + chunkSize) % historySize;
+        }
+    }
+    
+    //numChannels of 0 means any channel count
+    template <CarrierEngine engine, int numChannels>
+    void renderSegment (const juce::dsp::AudioBlock<SampleType>& block, int startSample, int numSamples)
+    {
+        auto* carrier = carrierBuffer.getWritePointer (0);
+        //with the channel count known at compile time the per channel loops unroll completely
+        auto channelsToProcess = numChannels > 0 ? (size_t) numChannels : block.getNumChannels();
+        
+        //work through the segment in fixed tiles, so the carrier and the audio it multiplies stay in L1 however big the host block is
+        for (int start = startSample; start < startSample + numSamples; start += carrierTileSize)
+        {
+            auto chunkSize = juce::jmin (carrierTileSize, startSample + numSamples - start);
+            //either the scratch tile or a window straight into the period cache
+            const float* chunkCarrier = carrier;
+           
+           #if RINGMOD_FIXED_POINT_ENGINE
+            //a steady audio rate carrier stays in integers from the table read to the multiply. Glides, bypass fades and
+            //sub-audio carriers are short lived or cheap already, so they take the float paths below
+            if constexpr (engine == CarrierEngine::fixedPoint)
+            {
+                auto increment = frequencyToIncrement (fromGlideDomain (smoothedFrequency.getTargetValue()));
+                
+                if (! smoothedFrequency.isSmoothing() && ! wetMix.isSmoothing() && ControlRateSine::getInterval (increment) == 0)
+                {
+                    phase = kernels.renderFixedPoint (fixedPointCarrier.get(), chunkSize, phase, increment, fixedPointTable);
+                    
+                    for (size_t channel = 0; channel < channelsToProcess; ++channel)
+                    {
+                        if constexpr (std::is_same_v<SampleType, double>)
+                            FixedPointSine::multiply (block.getChannelPointer (channel) + start, fixedPointCarrier.get(), chunkSize);
+                        else
+                            kernels.multiplyFixedPoint (block.getChannelPointer (channel) + start, fixedPointCarrier.get(), chunkSize);
+                    }
+                    
+                    continue;
+                }
+            }
+           #endif
+           
+            if (smoothedFrequency.isSmoothing())
+            {
+                //glides only last a few samples, so they always read the table whatever the engine
+                switch (interpolation)
+                {
+                    case SineTable::Interpolation::hermite: renderGlide<SineTable::Interpolation::hermite> (carrier, chunkSize); break;
+                    case SineTable::Interpolation::linear:  renderGlide<SineTable::Interpolation::linear>  (carrier, chunkSize); break;
+                    case SineTable::Interpolation::none:    renderGlide<SineTable::Interpolation::none>    (carrier, chunkSize); break;
+                }
+            }
+            else
+            {
+                //the whole chunk goes through the vector kernels, however short the segment
+                auto increment = frequencyToIncrement (fromGlideDomain (smoothedFrequency.getTargetValue()));
+                auto tilePosition = carrierPosition + (start - startSample);
+                
+                //sub-audio carriers only need evaluating every few samples, whichever engine is selected
+                if (auto controlInterval = ControlRateSine::getInterval (increment); controlInterval > 0)
+                {
+                    phase = ControlRateSine::render (carrier, chunkSize, phase, increment, amp, controlInterval, tilePosition, waveTable);
+                }
+                else if (auto* cached = readPeriodCache<engine> (increment, tilePosition, chunkSize))
+                {
+                    chunkCarrier = cached;
+                    phase += (juce::uint32) chunkSize * increment;
+                }
+                else if (shareCarrier && SharedCarrier::get().read ({ phase, increment, getRenderSettings<engine>(), chunkSize }, carrier))
+                {
+                    phase += (juce::uint32) chunkSize * increment;
+                }
+                else
+                {
+                    auto tilePhase = phase;
+                    phase = renderCarrier<engine> (carrier, chunkSize, phase, increment);
+                    
+                    if (shareCarrier)
+                        SharedCarrier::get().publish ({ tilePhase, increment, getRenderSettings<engine>(), chunkSize }, carrier);
+                }
+            }
+            
+            //while bypass is fading, blend the carrier towards unity: dry * (1 - mix) + dry * carrier * mix == dry * (1 + mix * (carrier - 1))
+            if (wetMix.isSmoothing())
+            {
+                for (int sample = 0; sample < chunkSize; ++sample)
+                    carrier[sample] = 1.0f + wetMix.getNextValue() * (chunkCarrier[sample] - 1.0f);
+                
+                chunkCarrier = carrier;
+            }
+            
+            //the carrier chunk is still in L1 while it is applied to each channel in turn
+            if constexpr (std::is_same_v<SampleType, double>)
+            {
+                //the carrier is always rendered in float, widening it is one vectorised pass before the double multiplies
+                auto* wideCarrier = doubleCarrier.get();
+                
+                for (int sample = 0; sample < chunkSize; ++sample)
+                    wideCarrier[sample] = (double) chunkCarrier[sample];
+                
+                for (size_t channel = 0; channel < channelsToProcess; ++channel)
+                    juce::FloatVectorOperations::multiply (block.getChannelPointer (channel) + start, wideCarrier, chunkSize);
+            }
+            else if constexpr (numChannels == 2)
+            {
+                kernels.multiplyStereo (block.getChannelPointer (0) + start, block.getChannelPointer (1) + start, chunkCarrier, chunkSize);
+            }
+            else
+            {
+                for (size_t channel = 0; channel < channelsToProcess; ++channel)
+                    kernels.multiply (block.getChannelPointer (channel) + start, chunkCarrier, chunkSize);
+            }
+        }
+        
+        carrierPosition += numSamples;
+    }
+    
+    //everything besides the phase and increment that changes what renderCarrier produces
+    template <CarrierEngine engine>
+    juce::uint32 getRenderSettings() const noexcept
+    {
+        return ((juce::uint32) engine << 4) | ((juce::uint32) interpolation << 2) | (juce::uint32) polynomialAccuracy;
+    }
+    
+    template <CarrierEngine engine>
+    juce::uint32 renderCarrier (float* dest, int numSamples, juce::uint32 startPhase, juce::uint32 increment)
+    {
+        if constexpr (engine == CarrierEngine::phasor)
+            return PhasorOscillator::render (dest, numSamples, startPhase, increment, amp);
+        else if constexpr (engine == CarrierEngine::polynomial)
+            return PolynomialSine::render (polynomialAccuracy, dest, numSamples, startPhase, increment, amp);
+       #if RINGMOD_FIXED_POINT_ENGINE
+        else if constexpr (engine == CarrierEngine::fixedPoint)
+            return fixedPointTable.render (dest, numSamples, startPhase, increment, amp);
+       #endif
+        else
+            return kernels.getRenderFunction (interpolation) (dest, numSamples, startPhase, increment, amp, waveTable);
+    }
+    
+    //a steady carrier with a short period is rendered once and then streamed, or nullptr if this one doesn't repeat soon enough
+    template <CarrierEngine engine>
+    const float* readPeriodCache (juce::uint32 increment, juce::int64 position, int numSamples)
+    {
+        //anything that changes what the engine renders has to throw the cached period away
+        if (! periodCache.setCarrier (increment, (int) getRenderSettings<engine>()))
+            return nullptr;
+        
+        auto firstPart = juce::jmin (numSamples, periodCache.getSamplesUntilRefill (position));
+        
+        if (firstPart == numSamples)
+            return readOrRefillPeriodCache<engine> (phase, increment, position, numSamples);
+        
+        //the tile runs over a refill point, so the two sides are put together in the scratch tile. The refill interval is
+        //never shorter than a tile, so there is only ever the one
+        auto* carrier = carrierBuffer.getWritePointer (0);
+        auto* cached = readOrRefillPeriodCache<engine> (phase, increment, position, firstPart);
+        std::copy (cached, cached + firstPart, carrier);
+        
+        cached = readOrRefillPeriodCache<engine> (phase + (juce::uint32) firstPart * increment, increment, position + firstPart, numSamples - firstPart);
+        std::copy (cached, cached + numSamples - firstPart, carrier + firstPart);
+        return carrier;
+    }
+    
+    template <CarrierEngine engine>
+    const float* readOrRefillPeriodCache (juce::uint32 startPhase, juce::uint32 increment, juce::int64 position, int numSamples)
+    {
+        if (auto* cached = periodCache.read (startPhase, position, numSamples))
+            return cached;
+        
+        //first use, past a refill point, or the phase has jumped, so render the period again
+        auto* refill = periodCache.beginRefill (startPhase, position);
+        renderCarrier<engine> (refill, periodCache.getRefillLength(), periodCache.getRefillPhase(), increment);
+        periodCache.endRefill();
+        return periodCache.read (startPhase, position, numSamples);
+    }
+    
+    void skipSegment (const juce::dsp::AudioBlock<SampleType>&, int, int numSamples)
+    {
+        smoothedFrequency.skip (numSamples);
+    }
+    
+    static SegmentRenderer getSegmentRenderer (bool isFullyBypassed, CarrierEngine engine, int numChannels) noexcept
+    {
+        //one instantiation per engine and mono / stereo / any channel count, looked up once per block instead of branched on per chunk
+        static constexpr SegmentRenderer renderers[4][3] =
+        {
+            { &RingModulator::renderSegment<CarrierEngine::wavetable, 1>,
+              &RingModulator::renderSegment<CarrierEngine::wavetable, 2>,
+              &RingModulator::renderSegment<CarrierEngine::wavetable, 0> },
+            { &RingModulator::renderSegment<CarrierEngine::phasor, 1>,
+              &RingModulator::renderSegment<CarrierEngine::phasor, 2>,
+              &RingModulator::renderSegment<CarrierEngine::phasor, 0> },
+            { &RingModulator::renderSegment<CarrierEngine::polynomial, 1>,
+              &RingModulator::renderSegment<CarrierEngine::polynomial, 2>,
+              &RingModulator::renderSegment<CarrierEngine::polynomial, 0> },
+            { &RingModulator::renderSegment<CarrierEngine::fixedPoint, 1>,
+              &RingModulator::renderSegment<CarrierEngine::fixedPoint, 2>,
+              &RingModulator::renderSegment<CarrierEngine::fixedPoint, 0> }
+        };
+        
+        if (isFullyBypassed)
+            return &RingModulator::skipSegment;
+        
+        auto layout = numChannels == 1 ? 0 : (numChannels == 2 ? 1 : 2);
+        return renderers[(int) engine][layout];
+    }
+    
+    template <SineTable::Interpolation mode>
+    void renderGlide (float* dest, int numSamples)
+    {
+        //the increment is ramped every sample, so a glide takes the same time whatever the host block size.
+        //The ramp goes through dest on its way to the kernel that turns it into increments
+        int glideLength = 0;
+        
+        while (glideLength < numSamples && smoothedFrequency.isSmoothing())
+            dest[glideLength++] = smoothedFrequency.getNextValue();
+        
+        kernels.glideIncrements (glideIncrements.get(), dest, glideLength, glideIsLogarithmic, (float) (4294967296.0 / processingSampleRate));
+        
+        //once it arrives, the rest of the tile steps exactly as a steady carrier would, wherever the tile started
+        std::fill (glideIncrements.get() + glideLength, glideIncrements.get() + numSamples,
+                   frequencyToIncrement (fromGlideDomain (smoothedFrequency.getTargetValue())));
+        
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            dest[sample] = waveTable.lookup<mode> (phase) * amp;
+            phase += glideIncrements[sample];
+        }
+    }
+    
+    void updateOversampling()
+    {
+        //everything was allocated in prepare, switching only picks a different one
+        activeOversampler = oversamplingOrder > 0 ? oversamplers[oversamplingFilter][oversamplingOrder - 1].get() : nullptr;
+        
+        if (activeOversampler != nullptr)
+            activeOversampler->reset();
+        
+        processingSampleRate = sampleRate * (1 << oversamplingOrder);
+        periodCache.invalidate();
+        smoothedFrequency.reset (processingSampleRate, 0.0005);
+        wetMix.reset (processingSampleRate, 0.01);
+        
+        //the half-band filters ring for a few milliseconds at most, so 50 ms of silence is plenty before they can be skipped
+        silenceTailSamples = oversamplingOrder > 0 ? juce::roundToInt (sampleRate * 0.05) : 0;
+        updateInputDelay();
+    }
+    
+    void updateInputDelay() noexcept
+    {
+        //rounded like the latency the host is told, so a padded path comes out within half a sample of the latency order's
+        inputDelay = juce::jmax (0, latencies[oversamplingFilter][latencyOrder] - latencies[oversamplingFilter][oversamplingOrder]);
+    }
+    
+    static bool isSilent (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        //only exact zeros count, anything quieter than that would still come out modulated
+        auto range = block.findMinAndMax();
+        return range.getStart() == SampleType (0) && range.getEnd() == SampleType (0);
+    }
+    
+    juce::uint32 frequencyToIncrement (double frequencyInHz) const noexcept
+    {
+        //one full cycle of the carrier is 2^32 steps of the phase accumulator
+        auto cyclesPerSample = juce::jlimit (0.0, 0.5, frequencyInHz / processingSampleRate);
+        return (juce::uint32) std::llround (cyclesPerSample * 4294967296.0);
+    }
+    
+    float toGlideDomain (double frequencyInHz) const noexcept
+    {
+        return glideIsLogarithmic ? (float) std::log2 (juce::jmax (frequencyInHz, 0.001)) : (float) frequencyInHz;
+    }
+    
+    double fromGlideDomain (float glideValue) const noexcept
+    {
+        return glideIsLogarithmic ? std::exp2 ((double) glideValue) : (double) glideValue;
+    }
+    
+    //==============================================================================
+    const SineTable& waveTable { SineTable::get() };
+   #if RINGMOD_FIXED_POINT_ENGINE
+    const FixedPointSine& fixedPointTable { FixedPointSine::get() };
+    //one tile of Q15 carrier for the fixed point engine
+    juce::HeapBlock <juce::int16> fixedPointCarrier;
+   #endif
+    //512 samples measured fastest for render plus a stereo multiply, smaller tiles pay too much per call overhead
+    static constexpr int carrierTileSize = 512;
+    static_assert (carrierTileSize <= SharedCarrier::maxSamples, "tiles have to fit in the shared carrier's slots");
+    juce::AudioBuffer <float> carrierBuffer;
+    //the float carrier widened for double precision processing
+    juce::HeapBlock <double> doubleCarrier;
+    //one tile of per sample increments while the frequency glides
+    juce::HeapBlock <juce::uint32> glideIncrements;
+    PeriodCache periodCache;
+    int maximumBlockSize { 0 };
+    double sampleRate { 44100.0 };
+    
+    std::unique_ptr <juce::dsp::Oversampling <SampleType>> oversamplers[2][maxOversamplingOrder];
+    juce::dsp::Oversampling <SampleType>* activeOversampler { nullptr };
+    int oversamplingOrder { 0 };
+    int oversamplingFilter { 0 };
+    //what was running before the last oversampling switch, faded out over the next block. Null when that was no oversampling
+    juce::dsp::Oversampling <SampleType>* outgoingOversampler { nullptr };
+    int outgoingOrder { 0 };
+    bool isCrossfading { false };
+    //a copy of the input for the outgoing path to process
+    juce::AudioBuffer <SampleType> crossfadeBuffer;
+    //each order's latency rounded to whole samples, per filter type, with 0 for no oversampling. Filled in prepare
+    int latencies[2][maxOversamplingOrder + 1] {};
+    //the latency is held at latencyOrder's by reading the input inputDelay samples late, and the outgoing path
+    //of a crossfade at outgoingInputDelay. The history is sized in prepare for the longest delay plus a block
+    int latencyOrder { 0 };
+    int inputDelay { 0 };
+    int outgoingInputDelay { 0 };
+    //fully bypassed with latency to keep, so the filters are skipped and the history read getLatencyInSamples late
+    bool isDry { false };
+    bool outgoingIsDry { false };
+    juce::AudioBuffer <SampleType> inputHistory;
+    int historyWritePosition { 0 };
+    bool wasKeepingInputHistory { false };
+    //the rate the carrier runs at, the sample rate times the oversampling factor
+    double processingSampleRate { 44100.0 };
+    //chosen in prepare from the instruction sets this CPU supports
+    CarrierKernels::Kernels kernels { CarrierKernels::getKernels (CarrierKernels::InstructionSet::scalar) };
+    
+    //phase is a 32 bit fixed point fraction of a cycle, so it wraps for free and never drifts
+    juce::uint32 phase { 0 };
+    //samples at the processing rate the phase has been stepped through since reset, or since the timeline last set it.
+    //Anything that works on a grid lines it up with this, so block boundaries never show in the output
+    juce::int64 carrierPosition { 0 };
+    float amp { 1.0f };
+    //1 while ring modulating, 0 when bypassed, ramped so toggling bypass doesn't click
+    juce::LinearSmoothedValue <float> wetMix { 1.0f };
+    bool bypassed { false };
+    //consecutive input samples that were exactly zero, and how many of them the oversampling filters need to fall silent
+    juce::int64 silentSamples { 0 };
+    int silenceTailSamples { 0 };
+    bool idle { false };
+    bool shareCarrier { false };
+    //where the host says this block starts, and where the last one said the next would, to spot playback starting or jumping
+    juce::int64 timelinePosition { 0 };
+    juce::int64 expectedTimelinePosition { -1 };
+    bool hasTimelinePosition { false };
+    //smooths either hertz or log2 hertz, depending on glideIsLogarithmic, and is stepped once per sample
+    juce::LinearSmoothedValue <float> smoothedFrequency { 20 };
+    bool glideIsLogarithmic { false };
+    CarrierEngine carrierEngine { CarrierEngine::wavetable };
+    PolynomialSine::Accuracy polynomialAccuracy { PolynomialSine::Accuracy::medium };
+    SineTable::Interpolation interpolation { SineTable::Interpolation::none };
+    
+    //frequency changes for the next process call, sorted by sample offset. Fixed size so nothing allocates on the audio thread
+    std::array <FrequencyChange, maxFrequencyChangesPerBlock> frequencyChanges;
+    int numFrequencyChanges { 0 };
+    
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RingModulator)
+};
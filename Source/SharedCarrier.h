@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    SharedCarrier.h
+    A process wide pool of rendered carrier tiles, so instances in lockstep
+    only render each tile once between them.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    A tile of carrier is completely determined by the phase it starts at, the
+    increment, the render settings and its length, so those make up the key.
+    Two instances playing the same frequency from the same phase origin ask
+    for the same keys. The first one to get there renders and publishes the
+    tile, and the others copy it.
+    
+    Each slot is a seqlock, like MeterSnapshot, but neither side ever waits.
+    A reader that finds the slot being written, or holding some other key,
+    just renders the tile itself. A writer that finds the slot already being
+    written skips publishing. Slots are picked by hashing the key, and a
+    collision only overwrites a tile someone may have wanted.
+*/
+class SharedCarrier
+{
+public:
+    static constexpr int numSlots = 64;
+    //the longest tile that can be shared, matching RingModulator's carrier tile
+    static constexpr int maxSamples = 512;
+    
+    struct Key
+    {
+        juce::uint32 phase;
+        juce::uint32 increment;
+        //whatever else changes what gets rendered, e.g. the engine and its interpolation or accuracy
+        juce::uint32 settings;
+        int numSamples;
+    };
+    
+    static SharedCarrier& get()
+    {
+        //one per process, constructed by whichever instance asks first
+        static SharedCarrier carrier;
+        return carrier;
+    }
+    
+    //copies the tile for this key into dest, or returns false if nobody has published it
+    bool read (const Key& key, float* dest) noexcept
+    {
+        jassert (key.numSamples <= maxSamples);
+        auto& slot = getSlot (key);
+        auto before = slot.sequence.load (std::memory_order_acquire);
+        
+        if ((before & 1) != 0 || ! slot.holds (key))
+            return false;
+        
+        for (int i = 0; i < key.numSamples; ++i)
+            dest[i] = slot.samples[i].load (std::memory_order_relaxed);
+        
+        std::atomic_thread_fence (std::memory_order_acquire);
+        return slot.sequence.load (std::memory_order_relaxed) == before;
+    }
+    
+    void publish (const Key& key, const float* source) noexcept
+    {
+        jassert (key.numSamples <= maxSamples);
+        auto& slot = getSlot (key);
+        auto sequenceNumber = slot.sequence.load (std::memory_order_relaxed);
+        
+        //someone else is writing this slot, and the tile they leave is as good as ours
+        if ((sequenceNumber & 1) != 0 || ! slot.sequence.compare_exchange_strong (sequenceNumber, sequenceNumber + 1, std::memory_order_relaxed))
+            return;
+        
+        std::atomic_thread_fence (std::memory_order_release);
+        
+        slot.phase.store (key.phase, std::memory_order_relaxed);
+        slot.increment.store (key.increment, std::memory_order_relaxed);
+        slot.settings.store (key.settings, std::memory_order_relaxed);
+        slot.numSamples.store (key.numSamples, std::memory_order_relaxed);
+        
+        for (int i = 0; i < key.numSamples; ++i)
+            slot.samples[i].store (source[i], std::memory_order_relaxed);
+        
+        slot.sequence.store (sequenceNumber + 2, std::memory_order_release);
+    }
+
+private:
+    //==============================================================================
+    //a cache line each, so instances on different cores don't fight over neighbouring slots
+    struct alignas (64) Slot
+    {
+        bool holds (const Key& key) const noexcept
+        {
+            return phase.load (std::memory_order_relaxed) == key.phase
+                && increment.load (std::memory_order_relaxed) == key.increment
+                && settings.load (std::memory_order_relaxed) == key.settings
+                && numSamples.load (std::memory_order_relaxed) == key.numSamples;
+        }
+        
+        std::atomic <juce::uint32> sequence { 0 };
+        std::atomic <juce::uint32> phase { 0 }, increment { 0 }, settings { 0 };
+        std::atomic <int> numSamples { 0 };
+        std::atomic <float> samples[maxSamples];
+    };
+    
+    SharedCarrier() = default;
+    
+    Slot& getSlot (const Key& key) noexcept
+    {
+        //consecutive tiles differ in phase, so they spread across the slots rather than chasing each other round one
+        auto hash = (key.phase ^ (key.increment * 2654435761u) ^ (key.settings * 40503u)) * 2654435761u;
+        return slots[(hash >> 16) % numSlots];
+    }
+    
+    Slot slots[numSlots];
+    
+    JUCE_DECLARE_NON_COPYABLE (SharedCarrier)
+};
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    SineTable.h
+    One cycle of sine, built once and shared by every instance of the plugin.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    The carrier wavetable. It is immutable once built, so a single copy is
+    safe to read from any number of audio threads at the same time.
+
+    The table is followed by guard points repeating its start, so the
+    interpolated lookups can read past the end without wrapping indices, and
+    a slope table holding the difference to the next point, so linear
+    interpolation is a single multiply-add.
+*/
+struct SineTable
+{
+    enum class Interpolation
+    {
+        none,
+        linear,
+        hermite
+    };
+    
+    //the length is a power of two so the top bits of a 32 bit phase accumulator index it directly
+    static constexpr int bits = 10;
+    static constexpr int size = 1 << bits;
+    static constexpr int phaseToIndexShift = 32 - bits;
+    static constexpr juce::uint32 fractionMask = (1u << phaseToIndexShift) - 1;
+    static constexpr int numGuardPoints = 3;
+    
+    static const SineTable& get()
+    {
+        //built on first use, thread safe since C++11
+        static const SineTable table;
+        return table;
+    }
+    
+    float operator[] (juce::uint32 phase) const noexcept    { return values[phase >> phaseToIndexShift]; }
+    
+    float lookupLinear (juce::uint32 phase) const noexcept
+    {
+        auto index = phase >> phaseToIndexShift;
+        return values[index] + getFraction (phase) * slopes[index];
+    }
+    
+    //4 point, 3rd order Hermite
+    float lookupHermite (juce::uint32 phase) const noexcept
+    {
+        //start one point early so the four points sit either side of the phase, the guard points cover the far end
+        auto index = ((phase >> phaseToIndexShift) - 1) & (size - 1);
+        auto* y = values + index;
+        auto t = getFraction (phase);
+        
+        auto c1 = 0.5f * (y[2] - y[0]);
+        auto c2 = y[0] - 2.5f * y[1] + 2.0f * y[2] - 0.5f * y[3];
+        auto c3 = 0.5f * (y[3] - y[0]) + 1.5f * (y[1] - y[2]);
+        
+        return ((c3 * t + c2) * t + c1) * t + y[1];
+    }
+    
+    template <Interpolation interpolation>
+    float lookup (juce::uint32 phase) const noexcept
+    {
+        if constexpr (interpolation == Interpolation::hermite)
+            return lookupHermite (phase);
+        else if constexpr (interpolation == Interpolation::linear)
+            return lookupLinear (phase);
+        else
+            return (*this)[phase];
+    }
+    
+    static float getFraction (juce::uint32 phase) noexcept
+    {
+        return (float) (phase & fractionMask) * (1.0f / (float) (1u << phaseToIndexShift));
+    }
+    
+    alignas (64) float values[size + numGuardPoints];
+    alignas (64) float slopes[size];
+    
+private:
+    SineTable()
+    {
+        for (int i = 0; i < size + numGuardPoints; ++i)
+            values[i] = (float) std::sin (juce::MathConstants<double>::twoPi * (i % size) / size);
+        
+        for (int i = 0; i < size; ++i)
+            slopes[i] = values[i + 1] - values[i];
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE (SineTable)
+};
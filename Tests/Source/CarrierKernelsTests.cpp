@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    CarrierKernelsTests.cpp
+    Every vectorised kernel this machine supports against the scalar reference,
+    including the fixed point engine's.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/CarrierKernels.h"
+#include "CarrierTestSignal.h"
+
+//==============================================================================
+class CarrierKernelsTests  : public juce::UnitTest
+{
+public:
+    CarrierKernelsTests()  : juce::UnitTest ("Carrier Kernels", "Ring Mod") {}
+    
+    void runTest() override
+    {
+        using CarrierKernels::InstructionSet;
+        
+        beginTest (getInstructionSetName (InstructionSet::scalar));
+        checkGlideIncrements (InstructionSet::scalar);
+        
+        for (auto instructionSet : { InstructionSet::sse2, InstructionSet::sse41, InstructionSet::avx2, InstructionSet::avx512, InstructionSet::neon })
+        {
+            beginTest (getInstructionSetName (instructionSet));
+            
+            if (! CarrierKernels::isSupported (instructionSet))
+            {
+                logMessage ("Not supported on this machine, skipped");
+                continue;
+            }
+            
+            expect (CarrierKernels::getKernels (instructionSet).instructionSet == instructionSet);
+            
+            for (auto interpolation : { SineTable::Interpolation::none, SineTable::Interpolation::linear, SineTable::Interpolation::hermite })
+                checkAgainstScalarReference (instructionSet, interpolation);
+            
+            checkFixedPointAgainstScalarReference (instructionSet);
+            checkGlideIncrements (instructionSet);
+        }
+    }
+
+private:
+    //renders and multiplies a test signal with both the given kernels and the scalar reference, and compares the results
+    void checkAgainstScalarReference (CarrierKernels::InstructionSet instructionSet, SineTable::Interpolation interpolation)
+    {
+        using namespace CarrierTestSignal;
+        
+        auto reference = CarrierKernels::getKernels (CarrierKernels::InstructionSet::scalar);
+        auto candidate = CarrierKernels::getKernels (instructionSet);
+        auto& table = SineTable::get();
+        
+        std::vector<float> expected (numSamples), actual (numSamples), input (numSamples);
+        
+        for (int i = 0; i < numSamples; ++i)
+            input[(size_t) i] = table[(juce::uint32) i * 0x00a3d70au];
+        
+        expectEquals (candidate.getRenderFunction (interpolation) (actual.data(), numSamples, startPhase, increment, 0.5f, table),
+                      reference.getRenderFunction (interpolation) (expected.data(), numSamples, startPhase, increment, 0.5f, table),
+                      "the returned phase differs");
+        
+        auto expectedProduct = input, actualProduct = input;
+        reference.multiply (expectedProduct.data(), expected.data(), numSamples);
+        candidate.multiply (actualProduct.data(), actual.data(), numSamples);
+        
+        auto stereoLeft = input, stereoRight = input;
+        candidate.multiplyStereo (stereoLeft.data(), stereoRight.data(), actual.data(), numSamples);
+        
+        expectLessOrEqual (getLargestDifference (expected, actual), CarrierKernels::tolerance, "render");
+        expectLessOrEqual (getLargestDifference (expectedProduct, actualProduct), CarrierKernels::tolerance, "multiply");
+        
+        //both channels take exactly what the mono multiply would have given them
+        expect (stereoLeft == actualProduct && stereoRight == actualProduct, "stereo multiply differs from mono");
+    }
+    
+    //the fixed point kernels are integer arithmetic all the way through, so they have to match the reference exactly
+    void checkFixedPointAgainstScalarReference (CarrierKernels::InstructionSet instructionSet)
+    {
+        using namespace CarrierTestSignal;
+        
+        auto reference = CarrierKernels::getKernels (CarrierKernels::InstructionSet::scalar);
+        auto candidate = CarrierKernels::getKernels (instructionSet);
+        auto& table = FixedPointSine::get();
+        
+        std::vector<juce::int16> expected (numSamples), actual (numSamples);
+        
+        expectEquals (candidate.renderFixedPoint (actual.data(), numSamples, startPhase, increment, table),
+                      reference.renderFixedPoint (expected.data(), numSamples, startPhase, increment, table),
+                      "the returned phase differs");
+        expect (actual == expected, "fixed point render");
+        
+        //past full scale on both sides, so the clipping is exercised too, and down to the smallest samples
+        std::vector<float> input (numSamples);
+        
+        for (int i = 0; i < numSamples; ++i)
+            input[(size_t) i] = 1.5f * std::sin ((float) i * 0.1f) * std::pow (0.97f, (float) (i % 300));
+        
+        auto expectedProduct = input, actualProduct = input;
+        reference.multiplyFixedPoint (expectedProduct.data(), expected.data(), numSamples);
+        candidate.multiplyFixedPoint (actualProduct.data(), actual.data(), numSamples);
+        
+        expect (actualProduct == expectedProduct, "fixed point multiply");
+    }
+    
+    //the glide kernels approximate exp2, so they are checked against the exact increments rather than the scalar kernel
+    void checkGlideIncrements (CarrierKernels::InstructionSet instructionSet)
+    {
+        using CarrierTestSignal::numSamples;
+        constexpr double sampleRate = 48000.0;
+        
+        auto kernels = CarrierKernels::getKernels (instructionSet);
+        std::vector<float> glideValues (numSamples);
+        std::vector<juce::uint32> increments (numSamples);
+        
+        for (auto isLogarithmic : { false, true })
+        {
+            //below zero and past Nyquist at either end, so the clamping is exercised too
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto position = (float) i / (float) (numSamples - 1);
+                glideValues[(size_t) i] = isLogarithmic ? juce::jmap (position, -10.0f, 16.0f) : juce::jmap (position, -100.0f, 30000.0f);
+            }
+            
+            kernels.glideIncrements (increments.data(), glideValues.data(), numSamples, isLogarithmic, (float) (4294967296.0 / sampleRate));
+            
+            auto largestError = 0.0;
+            
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto frequency = isLogarithmic ? std::exp2 ((double) glideValues[(size_t) i]) : (double) glideValues[(size_t) i];
+                auto expected = juce::jlimit (0.0, 0.5, frequency / sampleRate) * 4294967296.0;
+                //one step of slack, so increments near zero aren't held to a relative error they can't represent
+                largestError = juce::jmax (largestError, (std::abs ((double) increments[(size_t) i] - expected) - 1.0) / juce::jmax (1.0, expected));
+            }
+            
+            expectLessOrEqual (largestError, CarrierKernels::glideTolerance, isLogarithmic ? "logarithmic glide" : "linear glide");
+        }
+    }
+    
+    static float getLargestDifference (const std::vector<float>& a, const std::vector<float>& b)
+    {
+        auto largest = 0.0f;
+        
+        for (size_t i = 0; i < a.size(); ++i)
+            largest = juce::jmax (largest, std::abs (a[i] - b[i]));
+        
+        return largest;
+    }
+    
+    static juce::String getInstructionSetName (CarrierKernels::InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case CarrierKernels::InstructionSet::sse2:      return "SSE2";
+            case CarrierKernels::InstructionSet::sse41:     return "SSE4.1";
+            case CarrierKernels::InstructionSet::avx2:      return "AVX2";
+            case CarrierKernels::InstructionSet::avx512:    return "AVX-512";
+            case CarrierKernels::InstructionSet::neon:      return "NEON";
+            case CarrierKernels::InstructionSet::scalar:    break;
+        }
+        
+        return "Scalar";
+    }
+};
+
+static CarrierKernelsTests carrierKernelsTests;
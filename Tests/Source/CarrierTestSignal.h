@@ -0,0 +1,20 @@
+/*
+  ==============================================================================
+
+    CarrierTestSignal.h
+    The carrier every kernel and fixed point test renders.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace CarrierTestSignal
+{
+    //odd length and an awkward increment, so the vector bodies, the tails, the phase wrap and every fraction bit all get exercised
+    constexpr int numSamples = 1031;
+    constexpr juce::uint32 startPhase = 0xfff00000u;
+    constexpr juce::uint32 increment = 0x01234567u;
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    FixedPointSineTests.cpp
+    The fixed point engine's accuracy against a true sine in floating point.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/FixedPointSine.h"
+#include "CarrierTestSignal.h"
+
+//==============================================================================
+class FixedPointSineTests  : public juce::UnitTest
+{
+public:
+    FixedPointSineTests()  : juce::UnitTest ("Fixed Point Sine", "Ring Mod") {}
+    
+    void runTest() override
+    {
+        beginTest ("Agrees with the float reference");
+        checkAgainstFloatReference();
+        
+        beginTest ("Clips beyond full scale");
+        checkClipping();
+    }
+
+private:
+    //renders and multiplies a test signal both in fixed point and with a true sine in double, and compares the results
+    void checkAgainstFloatReference()
+    {
+        using namespace CarrierTestSignal;
+        
+        auto& table = FixedPointSine::get();
+        std::vector<juce::int16> carrier (numSamples);
+        table.render (carrier.data(), numSamples, startPhase, increment);
+        
+        auto largestCarrierError = 0.0f, largestProductError = 0.0f;
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto phase = startPhase + (juce::uint32) i * increment;
+            auto expected = std::sin (juce::MathConstants<double>::twoPi * (double) phase / 4294967296.0);
+            //a test input that sweeps most of the Q31 range without clipping
+            auto input = 0.9f * (float) std::cos ((double) i * 0.01);
+            
+            auto product = input;
+            FixedPointSine::multiply (&product, &carrier[(size_t) i], 1);
+            
+            largestCarrierError = juce::jmax (largestCarrierError, std::abs ((float) expected - (float) carrier[(size_t) i] / 32768.0f));
+            largestProductError = juce::jmax (largestProductError, std::abs ((float) (input * expected) - product));
+        }
+        
+        expectLessOrEqual (largestCarrierError, FixedPointSine::tolerance, "carrier");
+        expectLessOrEqual (largestProductError, FixedPointSine::tolerance, "product");
+    }
+    
+    void checkClipping()
+    {
+        //a full scale carrier sample is 32767 in Q15, just under 1
+        const juce::int16 carrier[] = { 32767, 32767, -32767, -32767 };
+        float audio[] = { 4.0f, -4.0f, 4.0f, -4.0f };
+        
+        FixedPointSine::multiply (audio, carrier, 4);
+        
+        expectWithinAbsoluteError (audio[0], 1.0f, 1.0e-4f);
+        expectWithinAbsoluteError (audio[1], -1.0f, 1.0e-4f);
+        expectWithinAbsoluteError (audio[2], -1.0f, 1.0e-4f);
+        expectWithinAbsoluteError (audio[3], 1.0f, 1.0e-4f);
+    }
+};
+
+static FixedPointSineTests fixedPointSineTests;
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Runs the ring modulator's unit tests, and fails if any of them do.
+    With --benchmark it logs the timings instead.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+int main (int argc, char** argv)
+{
+    juce::ArgumentList arguments (argc, argv);
+    
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTestsInCategory (arguments.containsOption ("--benchmark") ? "Ring Mod Benchmarks" : "Ring Mod");
+    
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        if (runner.getResult (i)->failures > 0)
+            return 1;
+    
+    return 0;
+}
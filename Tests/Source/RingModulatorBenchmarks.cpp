@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    RingModulatorBenchmarks.cpp
+    What each oversampling factor and filter type, and each carrier engine,
+    costs per sample.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/RingModulator.h"
+
+//==============================================================================
+/**
+    Only logs timings and never fails, so it lives in its own category and
+    only runs when the test runner is started with --benchmark.
+*/
+class RingModulatorBenchmarks  : public juce::UnitTest
+{
+public:
+    RingModulatorBenchmarks()  : juce::UnitTest ("Ring Modulator Benchmarks", "Ring Mod Benchmarks") {}
+    
+    void runTest() override
+    {
+        beginTest ("Oversampling, stereo at 48 kHz in 512 sample blocks");
+        
+        auto baseline = timePerSample (0, false);
+        logMessage ("off: " + formatTiming (baseline));
+        
+        for (auto useMinimumPhaseFilter : { false, true })
+        {
+            for (int order = 1; order <= RingModulator<float>::maxOversamplingOrder; ++order)
+                logMessage (juce::String (1 << order) + (useMinimumPhaseFilter ? "x IIR: " : "x FIR: ")
+                            + formatTiming (timePerSample (order, useMinimumPhaseFilter)));
+        }
+        
+        beginTest ("Carrier engines, stereo at 48 kHz in 512 sample blocks");
+        
+        for (auto engine : { CarrierEngine::wavetable, CarrierEngine::phasor, CarrierEngine::polynomial, CarrierEngine::fixedPoint })
+            logMessage (getEngineName (engine) + ": " + formatTiming (timePerSample (0, false, engine)));
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int blocksPerRun = 400;
+    static constexpr int numRuns = 15;
+    
+    //best of numRuns, in nanoseconds per stereo sample at the host rate
+    static double timePerSample (int order, bool useMinimumPhaseFilter, CarrierEngine engine = CarrierEngine::wavetable)
+    {
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::Random random (1);
+        
+        RingModulator<float> ringModulator;
+        ringModulator.setCarrierEngine (engine);
+        ringModulator.setInterpolation (SineTable::Interpolation::linear);
+        //no short period, so every tile of carrier is rendered rather than read from the period cache
+        ringModulator.setFrequency (441.37f);
+        ringModulator.setOversampling (order, useMinimumPhaseFilter);
+        ringModulator.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+        
+        auto best = std::numeric_limits<double>::max();
+        
+        for (int run = 0; run < numRuns; ++run)
+        {
+            juce::int64 ticks = 0;
+            
+            for (int i = 0; i < blocksPerRun; ++i)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    for (int sample = 0; sample < blockSize; ++sample)
+                        buffer.setSample (channel, sample, random.nextFloat() - 0.5f);
+                
+                juce::dsp::AudioBlock<float> block (buffer);
+                auto startTicks = juce::Time::getHighResolutionTicks();
+                ringModulator.process (juce::dsp::ProcessContextReplacing<float> (block));
+                ticks += juce::Time::getHighResolutionTicks() - startTicks;
+            }
+            
+            best = juce::jmin (best, juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / (blocksPerRun * blockSize));
+        }
+        
+        return best;
+    }
+    
+    static juce::String getEngineName (CarrierEngine engine)
+    {
+        switch (engine)
+        {
+            case CarrierEngine::phasor:         return "phasor";
+            case CarrierEngine::polynomial:     return "polynomial";
+            case CarrierEngine::fixedPoint:     return "fixed point";
+            case CarrierEngine::wavetable:      break;
+        }
+        
+        return "wavetable";
+    }
+    
+    static juce::String formatTiming (double nanoseconds)
+    {
+        //the share of each block's duration it takes, which is what the host cares about
+        return juce::String (nanoseconds, 1) + " ns/sample, " + juce::String (nanoseconds * sampleRate * 1.0e-7, 2) + "% of the deadline";
+    }
+};
+
+static RingModulatorBenchmarks ringModulatorBenchmarks;
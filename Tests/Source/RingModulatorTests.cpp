@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    RingModulatorTests.cpp
+    The processor as a whole, through its public interface.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/RingModulator.h"
+
+//==============================================================================
+class RingModulatorTests  : public juce::UnitTest
+{
+public:
+    RingModulatorTests()  : juce::UnitTest ("Ring Modulator", "Ring Mod") {}
+    
+    void runTest() override
+    {
+        beginTest ("Control rate carrier is independent of the block size");
+        expectSameForEveryBlockSize (2.0f, CarrierEngine::wavetable, SineTable::Interpolation::hermite);
+        expectSameForEveryBlockSize (2.0f, CarrierEngine::polynomial, SineTable::Interpolation::none);
+        
+        beginTest ("Cached period is independent of the block size");
+        expectSameForEveryBlockSize (440.0f, CarrierEngine::wavetable, SineTable::Interpolation::none);
+        expectSameForEveryBlockSize (440.0f, CarrierEngine::wavetable, SineTable::Interpolation::hermite);
+        expectSameForEveryBlockSize (1000.0f, CarrierEngine::phasor, SineTable::Interpolation::none);
+        //would need refilling more than once a tile, so it is rendered instead of cached
+        expectSameForEveryBlockSize (3200.001f, CarrierEngine::wavetable, SineTable::Interpolation::none);
+        
+        beginTest ("Rendered carrier is independent of the block size");
+        //too far from a whole period to cache, so the vector kernels' bodies and their scalar tails have to round alike
+        //wherever the block size puts the split between them
+        expectSameForEveryBlockSize (3200.001f, CarrierEngine::wavetable, SineTable::Interpolation::linear);
+        
+        beginTest ("Lower oversampling is padded to the latency order's latency");
+        expectPaddedLatency (false);
+        expectPaddedLatency (true);
+        
+        beginTest ("Fully bypassed input skips the oversampling filters");
+        expectDryBypass (false);
+        expectDryBypass (true);
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int maximumBlockSize = 512;
+    static constexpr int numSamples = 48000;
+    
+    //renders the same input in several block sizes and checks that every sample comes out identical
+    void expectSameForEveryBlockSize (float frequency, CarrierEngine engine, SineTable::Interpolation interpolation)
+    {
+        auto expected = render (maximumBlockSize, frequency, engine, interpolation);
+        
+        for (auto blockSize : { 1024, 100, 64, 37 })
+        {
+            auto actual = render (blockSize, frequency, engine, interpolation);
+            int numDifferent = 0;
+            
+            for (int i = 0; i < numSamples; ++i)
+                if (actual.getSample (0, i) != expected.getSample (0, i))
+                    ++numDifferent;
+            
+            expectEquals (numDifferent, 0, juce::String (frequency) + " Hz in blocks of " + juce::String (blockSize));
+        }
+    }
+    
+    //every order reports the latency order's latency, and with no filters in the way an impulse comes out exactly that late
+    void expectPaddedLatency (bool useMinimumPhaseFilter)
+    {
+        RingModulator<float> ringModulator;
+        ringModulator.setBypassed (true);
+        ringModulator.setOversampling (RingModulator<float>::maxOversamplingOrder, useMinimumPhaseFilter);
+        ringModulator.prepare ({ sampleRate, (juce::uint32) maximumBlockSize, 1 });
+        
+        auto expectedLatency = ringModulator.getLatencyInSamples();
+        ringModulator.setLatencyOrder (RingModulator<float>::maxOversamplingOrder);
+        
+        for (int order = RingModulator<float>::maxOversamplingOrder; order >= 0; --order)
+        {
+            ringModulator.setOversampling (order, useMinimumPhaseFilter);
+            expectEquals (ringModulator.getLatencyInSamples(), expectedLatency, "order " + juce::String (order));
+        }
+        
+        //the block the switch crossfades in is left behind before the impulse goes in
+        juce::AudioBuffer<float> buffer (1, maximumBlockSize);
+        juce::dsp::AudioBlock<float> block (buffer);
+        //silence, as this block comes back out of the padding ahead of the impulse
+        buffer.clear();
+        ringModulator.process (juce::dsp::ProcessContextReplacing<float> (block));
+        
+        buffer.clear();
+        buffer.setSample (0, 0, 1.0f);
+        ringModulator.process (juce::dsp::ProcessContextReplacing<float> (block));
+        
+        for (int i = 0; i < maximumBlockSize; ++i)
+            if (buffer.getSample (0, i) != 0.0f)
+                expectEquals (i, expectedLatency, "where the impulse came out");
+        
+        expectEquals (buffer.getSample (0, expectedLatency), 1.0f, "the impulse came out");
+    }
+    
+    //the filters would smear the input, so coming out exactly as it went in, only later, means they were skipped
+    void expectDryBypass (bool useMinimumPhaseFilter)
+    {
+        RingModulator<float> ringModulator;
+        ringModulator.setBypassed (true);
+        ringModulator.setOversampling (1, useMinimumPhaseFilter);
+        ringModulator.prepare ({ sampleRate, (juce::uint32) maximumBlockSize, 1 });
+        
+        auto latency = ringModulator.getLatencyInSamples();
+        juce::AudioBuffer<float> input (1, numSamples);
+        juce::Random random (1);
+        
+        for (int i = 0; i < numSamples; ++i)
+            input.setSample (0, i, random.nextFloat() - 0.5f);
+        
+        juce::AudioBuffer<float> buffer (input);
+        
+        for (int start = 0; start < numSamples; start += maximumBlockSize)
+        {
+            auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) juce::jmin (maximumBlockSize, numSamples - start));
+            ringModulator.process (juce::dsp::ProcessContextReplacing<float> (block));
+        }
+        
+        int mismatches = 0;
+        
+        for (int i = 0; i < numSamples; ++i)
+            if (buffer.getSample (0, i) != (i < latency ? 0.0f : input.getSample (0, i - latency)))
+                ++mismatches;
+        
+        expectEquals (mismatches, 0, "samples that differ from the delayed input");
+    }
+    
+    static juce::AudioBuffer<float> render (int blockSize, float frequency, CarrierEngine engine, SineTable::Interpolation interpolation)
+    {
+        juce::AudioBuffer<float> buffer (1, numSamples);
+        juce::Random random (1);
+        
+        //a stretch of silence in the middle, so the idle skip has to keep the carrier where rendering would have
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample (0, i, i >= numSamples / 3 && i < numSamples / 2 ? 0.0f : random.nextFloat() - 0.5f);
+        
+        RingModulator<float> ringModulator;
+        ringModulator.setCarrierEngine (engine);
+        ringModulator.setInterpolation (interpolation);
+        ringModulator.setFrequency (frequency);
+        ringModulator.prepare ({ sampleRate, (juce::uint32) maximumBlockSize, 1 });
+        
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            auto block = juce::dsp::AudioBlock<float> (buffer).getSubBlock ((size_t) start, (size_t) juce::jmin (blockSize, numSamples - start));
+            ringModulator.process (juce::dsp::ProcessContextReplacing<float> (block));
+        }
+        
+        return buffer;
+    }
+};
+
+static RingModulatorTests ringModulatorTests;